@@ -13,19 +13,56 @@
 # include <stdio.h> /* printf */
 # include <stdlib.h> /* malloc */
 # include <string.h> /* memmove */
+# include <sys/types.h> /* ssize_t */
+# include <stdint.h> /* uint64_t */
 
 # ifndef BYTE
 #	define BYTE unsigned char
 # endif
 
+/**
+ *	Politique de croissance de la capacité du tableau, quand il est plein
+ *
+ *	ARRAY_GROWTH_HALF   : la capacité est multipliée par 1.5 (par défaut)
+ *	ARRAY_GROWTH_DOUBLE : la capacité est multipliée par 2
+ *	ARRAY_GROWTH_LINEAR : la capacité est multipliée par 2, jusqu'à ARRAY_LINEAR_BYTES octets,
+ *			puis elle grossit de ARRAY_LINEAR_BYTES octets à chaque fois
+ *			(pour les tres grands tableaux, où doubler gaspillerait trop de mémoire)
+ */
+typedef enum	e_array_growth {
+	ARRAY_GROWTH_HALF,
+	ARRAY_GROWTH_DOUBLE,
+	ARRAY_GROWTH_LINEAR
+}		t_array_growth;
+
+/** capacité minimum d'un tableau qui grossit */
+# ifndef ARRAY_MIN_CAPACITY
+#	define ARRAY_MIN_CAPACITY 4
+# endif
+
+/** taille en octets à partir de laquelle ARRAY_GROWTH_LINEAR grossit de manière linéaire */
+# ifndef ARRAY_LINEAR_BYTES
+#	define ARRAY_LINEAR_BYTES (64 * 1024 * 1024)
+# endif
+
+/**
+ *	taille en octets à partir de laquelle les valeurs sont allouées via 'mmap()' (linux seulement):
+ *	le tableau grossit alors via 'mremap()', qui déplace les pages au lieu de copier les valeurs
+ */
+# ifndef ARRAY_MMAP_BYTES
+#	define ARRAY_MMAP_BYTES (1024 * 1024)
+# endif
+
 /**
  *	Structure de donnée: tableau dynamique ("Array list")
  */
 typedef struct  s_array {
-	BYTE             * values;	/* les valeurs du tableau */
-	unsigned int    capacity;	/* capacité mémoire du tableau 'values' */
-	unsigned int    size;		/* nombre d'element dans le tableau 'values' */
-	unsigned int	elemSize;	/* taille d'un element du tableau */
+	BYTE		* values;	/* les valeurs du tableau */
+	size_t		capacity;	/* capacité mémoire du tableau 'values' */
+	size_t		size;		/* nombre d'element dans le tableau 'values' */
+	size_t		elemSize;	/* taille d'un element du tableau */
+	size_t		mapped;		/* taille en octets de 'values' s'il est alloué via 'mmap()', 0 sinon */
+	t_array_growth	growth;		/* politique de croissance du tableau */
 }               t_array;
 
 /**
@@ -33,7 +70,7 @@ typedef struct  s_array {
  *	@ensure  : alloue en mémoire un tableau dynamique
  *	@assign  : ------------------
  */
-t_array * array_new(unsigned int defaultCapacity, unsigned int elemSize);
+t_array * array_new(size_t defaultCapacity, size_t elemSize);
 
 /**
  *	@require : 'array': tableau dynamique alloué via 'array_new()'
@@ -48,7 +85,7 @@ void array_delete(t_array * array);
  *			ou NULL si erreur
  *	@assign  : -----------
  */
-void * array_get(t_array * array, unsigned int index);
+void * array_get(t_array * array, size_t index);
 
 /**
  *	@require : un tableau 'array', un index, et une valeur 'value'
@@ -56,15 +93,15 @@ void * array_get(t_array * array, unsigned int index);
  *			renvoie -1 si erreur, sinon l'index ou l'élément a été inséré
  *	@assign  : grossit la capacité du tableau si necessaire
  */
-int array_set(t_array * array, unsigned int index, void * value);
+ssize_t array_set(t_array * array, size_t index, void * value);
 
 /**
  *	@require : un tableau 'array' et une valeur 'value'
  *	@ensure  : modifie la capacité du tableau.
  *			renvoie -1 si erreur, 0 sinon
- *	@assign  : 'array->values' peut être modifié par 'realloc()'
+ *	@assign  : 'array->values' peut être modifié par 'realloc()' ou 'mremap()'
  */
-int array_grow(t_array * array, unsigned int capacity);
+int array_grow(t_array * array, size_t capacity);
 
 /**
  *	@require : un tableau 'array' et une capacité 'capacity'
@@ -72,40 +109,47 @@ int array_grow(t_array * array, unsigned int capacity);
  *			renvoie -1 si erreur, 0 sinon
  *	@assign  : @see array_grow()
  */
-int array_ensure_capacity(t_array * array, unsigned int capacity);
-	
+int array_ensure_capacity(t_array * array, size_t capacity);
+
+/**
+ *	@require : un tableau 'array' et une politique de croissance
+ *	@ensure  : les prochaines croissances du tableau suivront la politique 'growth'
+ *	@assign  : array->growth
+ */
+void array_set_growth(t_array * array, t_array_growth growth);
+
 /**
  *	@require : un tableau 'array' et une valeur 'value'
  *	@ensure  : ajoutes la valeur 'value' en bout de tableau 'array'
- *			return -1 si erreur, 0 sinon
+ *			renvoie -1 si erreur, sinon l'index du nouvel élément
  *	@assign  : modifie les valeurs du tableau
  */
-int array_add(t_array * array, void * value);
+ssize_t array_add(t_array * array, void * value);
 
 /**
  *	@require : un tableau 'array' une valeur 'value', et un entier 'n'
  *	@ensure  : ajoutes n fois la valeur 'value' en bout de tableau 'array'
- *			return -1 si erreur, 0 sinon
+ *			renvoie -1 si erreur, sinon l'index du premier élément ajouté
  *	@assign  : modifie les valeurs du tableau
  */
-int array_addn(t_array * array, void * value, unsigned int n);
+ssize_t array_addn(t_array * array, void * value, size_t n);
 
 /**
  *	@require : un tableau 'array', et un entier 'n'
  *	@ensure  : ajoutes n valeur non initialisé dans le tableau (allocation)
- *			return -1 si erreur, 0 sinon
+ *			renvoie -1 si erreur, sinon l'index du premier élément ajouté
  *	@assign  : modifie array->size
  */
-int array_addempty(t_array * array, unsigned int n);
+ssize_t array_addempty(t_array * array, size_t n);
 
 /**
  *	@require : un tableau 'array', un tableau de valeur 'values',
  *			et la taille de 'values'
  *	@ensure  : ajoutes les valeurs 'values' en bout de tableau 'array'
- *			return -1 si erreur, 0 sinon
+ *			renvoie -1 si erreur, sinon l'index du premier élément ajouté
  *	@assign  : modifie les valeurs du tableau
  */
-int array_add_all(t_array * array, void * values, unsigned int count);
+ssize_t array_add_all(t_array * array, void * values, size_t count);
 
 /**
  *	@require : un tableau 'array'
@@ -127,7 +171,7 @@ void array_trim(t_array * array);
  *	@ensure  : supprime l'élément à l'index donné
  *	@assign  : les index des éléments suivant sont décalés pour éviter la fragmentation
  */
-void array_remove(t_array * array, unsigned int index);
+void array_remove(t_array * array, size_t index);
 
 /**
  *	@require : un tableau 'array'
@@ -143,6 +187,44 @@ void array_removelast(t_array * array);
  */
 void array_sort(t_array * array, int (*cmpf)(const void * left, const void * right));
 
+/**
+ *	@require : un tableau 'array', une fonction de comparaison (voir strcmp()),
+ *			et un nombre de threads (0 pour le nombre de processeurs, au plus ARRAY_SORT_MAX_THREADS)
+ *	@ensure  : tri le tableau dans l'ordre croissant de la fonction de comparaison, en parallèle
+ *			("sample sort": le tableau est découpé en paquets de valeurs, triés chacun par un thread).
+ *			Le tri n'est pas stable. Compiler avec -lpthread.
+ *			renvoie -1 si erreur (le tableau n'est alors pas modifié), 0 sinon
+ *	@assign  : modifie les index des elements du tableau (en triant les elements)
+ */
+int array_sort_parallel(t_array * array, int (*cmpf)(const void * left, const void * right), unsigned int nthreads);
+
+/**
+ *	fonction renvoyant la clef entière d'un élément du tableau (@see array_sort_key())
+ */
+typedef uint64_t (*t_array_key_function)(void const * value);
+
+/**
+ *	@require : un tableau 'array' d'éléments du type donné ('elemSize' doit être sa taille)
+ *	@ensure  : tri le tableau dans l'ordre croissant, par un tri par base (bien plus rapide que
+ *			'array_sort()', aucune fonction de comparaison n'est appelée)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_u32(t_array * array);
+int array_sort_u64(t_array * array);
+int array_sort_i64(t_array * array);
+int array_sort_f32(t_array * array);
+int array_sort_f64(t_array * array);
+
+/**
+ *	@require : un tableau 'array', et une fonction 'keyf' renvoyant la clef entière d'un élément
+ *	@ensure  : tri le tableau dans l'ordre croissant des clefs, par un tri par base stable
+ *			(i.e, des structures triées selon un de leur champ entier)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_key(t_array * array, t_array_key_function keyf);
+
 /**
  *	@require : un tableau 'array'
  *	@ensure  : inverse l'ordre des elements du tableau
@@ -42,6 +42,11 @@ t_bitmap * bitmap_new(size_t sizeX);
 t_bitmap * bitmap_new2(size_t sizeX, size_t sizeY);
 t_bitmap * bitmap_new3(size_t sizeX, size_t sizeY, size_t sizeZ);
 
+/**
+ * set every bits to zero (a new bitmap isnt initialized)
+ */
+void bitmap_zeroes(t_bitmap * bitmap);
+
 /**
  * get a copy of the bitmap, should be de-allocated using 'bitmap_delete()'
  */
@@ -0,0 +1,127 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef CACHE_H
+# define CACHE_H
+
+# include "common.h"
+# include "hmap.h"
+# include "list.h"
+
+/**
+ *  Bounded cache: a hash map which evicts values once it holds too many of them (or too many bytes)
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - a 't_hmap' finds the entries, and a 't_list' orders them: lookups, insertions and
+ *        evictions are done in constant time (the map node handles are used to remove the evicted entries)
+ *      - two eviction policies:
+ *          CACHE_LRU   : the least recently used entry is evicted. A hit moves the entry at
+ *                        the end of the list.
+ *          CACHE_CLOCK : an approximation of LRU. A hit only sets a 'referenced' flag on the entry
+ *                        (the map and the list arent modified, and the flag and counters are set
+ *                        atomically, so 'cache_get()' can run under a read lock), and a 'hand' goes
+ *                        around the list to find an entry which wasnt referenced since its last visit.
+ *      - 'datafreef' and 'keyfreef' are called on the evicted values
+ *      - hits, misses and evictions are counted, to tune the cache capacity
+ *
+ *  example for a string cache of at most 1024 entries:
+ *
+ *      t_cache * cache = cache_new(CACHE_LRU, 1024, 0, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      cache_put(cache, strdup("Hello world"), strdup("ima key"), 0);
+ *      char *helloworld = cache_get(cache, "ima key"); //"Hello world", if it wasnt evicted
+ */
+
+typedef enum    e_cache_policy {
+    CACHE_LRU,
+    CACHE_CLOCK
+}               t_cache_policy;
+
+typedef struct  s_cache_entry {
+    void const * key; //the key used
+    void const * data; //the data holds
+    unsigned long int size; //size in bytes of the value, as given to 'cache_put()'
+    t_hmap_node * handle; //the node of the entry in the hash map
+    int referenced; //CACHE_CLOCK: 1 if the entry was hit since the hand last visited it
+}               t_cache_entry;
+
+typedef struct  s_cache {
+    t_hmap * hmap; //map of the keys to their entries
+    t_list entries; //the entries, from the next to be evicted (LRU) or in clock order (CLOCK)
+    t_list_node * hand; //CACHE_CLOCK: next entry the hand visits
+    t_cache_policy policy; //eviction policy
+    unsigned long int max_entries; //maximum number of entries (0 for no limit)
+    unsigned long int max_bytes; //maximum sum of the entries size (0 for no limit)
+    unsigned long int bytes; //sum of the entries size
+    unsigned long int hits; //number of 'cache_get()' which found their key
+    unsigned long int misses; //number of 'cache_get()' which didnt find their key
+    unsigned long int evictions; //number of entries evicted
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_cache;
+
+/**
+ *  Create a new cache:
+ *
+ *  policy      : CACHE_LRU or CACHE_CLOCK
+ *  max_entries : maximum number of entries, 0 for no limit
+ *  max_bytes   : maximum sum of the entries size (see 'cache_put()'), 0 for no limit
+ *  hashf       : hash function to use on keys
+ *  keycmpf     : comparison function to use when searching a data
+ */
+t_cache * cache_new(t_cache_policy policy, unsigned long int max_entries, unsigned long int max_bytes,
+                    t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the cache from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void cache_delete(t_cache * cache);
+
+/**
+ *  Get data from the cache, NULL if the key isnt found. The entry is marked as recently used.
+ */
+void * cache_get(t_cache * cache, void const * key);
+
+/**
+ *  Insert a value into the cache, and evict entries until it fits in the budget.
+ *  If the key is already in the cache, its data and key are replaced (and the old ones freed).
+ *
+ *  size : size in bytes of the value, counted against 'max_bytes' (may be 0 if there is no byte limit)
+ *
+ *  return the given data if it was inserted properly, NULL elseway (i.e, if 'size' is over 'max_bytes':
+ *  the data and key are then left to the caller)
+ */
+void const * cache_put(t_cache * cache, void const * data, void const * key, unsigned long int size);
+
+/**
+ *  Remove the value of the key from the cache (calling 'keyfreef' and 'datafreef')
+ *  return 1 if the element was removed, 0 elseway
+ */
+int cache_remove(t_cache * cache, void const * key);
+
+/**
+ *  Macro to iterate though the cache entries (from the next to be evicted, in LRU policy)
+ *
+ *  i.e:
+ *      CACHE_ITER_START(cache, char *, str) {
+ *          puts(str);
+ *      }
+ *      CACHE_ITER_END(cache, char *, str)
+ */
+# define CACHE_ITER_START(C, T, V)\
+{\
+    t_list * __entries = &((C)->entries);\
+    LIST_ITER_START(__entries, t_cache_entry *, entry) {\
+        T V = (T)(entry->data);
+# define CACHE_ITER_END(C, T, V)\
+    }\
+    LIST_ITER_END(__entries, t_cache_entry *, entry)\
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef CKMAP_H
+# define CKMAP_H
+
+# include "common.h"
+
+/**
+ *  Bucketized cuckoo hash map, with the same API as 'hmap.h'
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - a key can only be in one of its two buckets: the first one is given by its hash, and the
+ *        second one by the first one and its tag (so a value can be moved without hashing its key).
+ *        A bucket holds CKMAP_WAYS values, and is a cache line: a lookup reads at most two cache lines
+ *        (plus the stash, which is almost always empty)
+ *      - each value has a tag (32 bits of its key hash) next to it in the bucket: 'keycmpf' is only
+ *        called on the values which tag matches, so the keys of the other values arent read
+ *      - if both buckets are full, a value of one of them is moved to its other bucket (it is "kicked"),
+ *        and so on. If the chain of kicks gets longer than CKMAP_MAX_KICKS, the homeless value goes into
+ *        a small stash, and if the stash is full, the table doubles
+ *      - the table can be filled up to about 90%
+ *      - an empty slot has a NULL key: keys cant be NULL
+ *
+ *  example for a string hashmap:
+ *
+ *      t_ckmap * map = ckmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      ckmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      char *helloworld = ckmap_get(map, "ima key"); //now contains "Hello world"
+ */
+
+/** number of values of a bucket (a bucket, with the tags, is a 64 bytes cache line) */
+# define CKMAP_WAYS 3
+
+/** maximum number of values kicked by an insertion, before the stash is used */
+# ifndef CKMAP_MAX_KICKS
+#   define CKMAP_MAX_KICKS 128
+# endif
+
+/** number of values the stash can hold, before the table doubles */
+# ifndef CKMAP_STASH_SIZE
+#   define CKMAP_STASH_SIZE 4
+# endif
+
+typedef struct  s_ckmap_bucket {
+    void const * keys[CKMAP_WAYS]; //the keys used (NULL for an empty slot)
+    void const * datas[CKMAP_WAYS]; //the data holds
+    unsigned int tags[CKMAP_WAYS]; //the tags of the keys hash
+}               CACHE_ALIGNED t_ckmap_bucket;
+
+typedef struct  s_ckmap_slot {
+    void const * key; //the key used
+    void const * data; //the data holds
+    unsigned int tag; //the tag of the key hash
+}               t_ckmap_slot;
+
+typedef struct  s_ckmap {
+    t_ckmap_bucket * buckets; //the buckets
+    unsigned long int nbuckets; //number of buckets (a power of two)
+    t_ckmap_slot stash[CKMAP_STASH_SIZE]; //values which couldnt be placed in their buckets
+    unsigned int stash_size; //number of values in the stash
+    unsigned long int size; //number of value set
+    unsigned long int seed; //state of the generator choosing the values to kick
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where slot keys are sent as parameters
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_ckmap;
+
+/**
+ *  Create a new hashmap:
+ *
+ *  capacity : number of values the map should hold before growing
+ *  hashf    : hash function to use on inserted elements
+ *  cmpf     : comparison function to use when searching a data
+ */
+t_ckmap * ckmap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void ckmap_delete(t_ckmap * ckmap);
+
+/**
+ *  Insert a value into the hashmap:
+ *
+ *  return the given data if it was inserted properly, NULL elseway
+ */
+void const * ckmap_insert(t_ckmap * ckmap, void const * data, void const * key);
+
+/**
+ *  Get data from the hashmap, NULL if the key isnt found
+ */
+void * ckmap_get(t_ckmap * ckmap, void const * key);
+
+/**
+ *  Remove the data pointer from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int ckmap_remove_data(t_ckmap * ckmap, void const * data);
+
+/**
+ *  Remove the data which match with the given key from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int ckmap_remove_key(t_ckmap * ckmap, void const * key);
+
+/**
+ *  Macro to iterate though to hash map (the buckets, then the stash)
+ *
+ *  i.e:
+ *      CKMAP_ITER_START(ckmap, char *, str) {
+ *          puts(str);
+ *      }
+ *      CKMAP_ITER_END(ckmap, char *, str)
+ */
+# define CKMAP_ITER_START(H, T, V)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->nbuckets * CKMAP_WAYS + (H)->stash_size ; __i++) {\
+        t_ckmap_slot __slot = __i < (H)->nbuckets * CKMAP_WAYS ?\
+            (t_ckmap_slot){(H)->buckets[__i / CKMAP_WAYS].keys[__i % CKMAP_WAYS], (H)->buckets[__i / CKMAP_WAYS].datas[__i % CKMAP_WAYS], 0} :\
+            (H)->stash[__i - (H)->nbuckets * CKMAP_WAYS];\
+        if (__slot.key != NULL) {\
+            t_ckmap_slot * slot = &__slot;\
+            T V = (T)(slot->data);
+# define CKMAP_ITER_END(H, T, V)\
+        }\
+    }\
+}
+
+#endif
@@ -27,11 +27,32 @@
 typedef void (*t_function)();
 typedef int	(*t_cmp_function) (void const * a, void const * b);
 typedef unsigned long int (*t_hash_function) (void const * v);
+typedef unsigned long int (*t_size_function) (void const * v);
+typedef void * (*t_update_function) (void * data, void * param);
 
 
 typedef t_function t_f;
 typedef t_cmp_function t_cmpf;
 typedef t_hash_function t_hf;
+typedef t_size_function t_sf;
+typedef t_update_function t_uf;
+
+/** hint the processor to load the given address in cache */
+# if defined(__GNUC__)
+#   define PREFETCH(A) __builtin_prefetch((A))
+# else
+#   define PREFETCH(A) ((void)(A))
+# endif
+
+/** align a type on a cache line (to avoid false sharing between threads) */
+# ifndef CACHE_LINE
+#   define CACHE_LINE 64
+# endif
+# if defined(__GNUC__)
+#   define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE)))
+# else
+#   define CACHE_ALIGNED
+# endif
 
 # define MICROSEC(V)    {\
     struct timeval tv;\
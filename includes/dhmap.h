@@ -0,0 +1,113 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef DHMAP_H
+# define DHMAP_H
+
+# include <stdint.h>
+# include "common.h"
+
+/**
+ *  Dense, insertion ordered hash map (the layout of CPython dictionaries), with the same API as 'hmap.h'
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - the values are appended in a dense array of entries, in insertion order
+ *      - a small open addressing table of indices (1, 2, 4 or 8 bytes each, depending on
+ *        the number of entries) maps the hashes to the entries
+ *      - iterating, deleting or saving the map are linear scans over contiguous memory
+ *      - a removed entry leaves a hole in the entries array, until the next resize compacts it.
+ *        Holes are marked with a NULL key: keys cant be NULL.
+ *
+ *  example for a string hashmap:
+ *
+ *      t_dhmap * map = dhmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      dhmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      char *helloworld = dhmap_get(map, "ima key"); //now contains "Hello world"
+ */
+
+typedef struct  s_dhmap_entry {
+    unsigned long int hash; //hash of the key
+    void const * key; //the key used (NULL if this entry was removed)
+    void const * data; //the data holds
+}               t_dhmap_entry;
+
+typedef struct  s_dhmap {
+    void * indices; //the table of indices in 'entries'
+    t_dhmap_entry * entries; //the entries, in insertion order
+    unsigned long int capacity; //number of indices (a power of two)
+    unsigned int index_size; //size in bytes of an index (1, 2, 4 or 8)
+    unsigned long int nentries; //number of entries used (including removed ones)
+    unsigned long int size; //number of value set
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where entry keys are sent as parameters
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_dhmap;
+
+/**
+ *  Create a new hashmap:
+ *
+ *  capacity : number of values the map should hold before growing
+ *  hashf    : hash function to use on inserted elements
+ *  cmpf     : comparison function to use when searching a data
+ */
+t_dhmap * dhmap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void dhmap_delete(t_dhmap * dhmap);
+
+/**
+ *  Insert a value into the hashmap:
+ *
+ *  return the given data if it was inserted properly, NULL elseway
+ */
+void const * dhmap_insert(t_dhmap * dhmap, void const * data, void const * key);
+
+/**
+ *  Get data from the hashmap, NULL if the key isnt found
+ */
+void * dhmap_get(t_dhmap * dhmap, void const * key);
+
+/**
+ *  Remove the data pointer from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int dhmap_remove_data(t_dhmap * dhmap, void const * data);
+
+/**
+ *  Remove the data which match with the given key from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int dhmap_remove_key(t_dhmap * dhmap, void const * key);
+
+/**
+ *  Macro to iterate though to hash map, in insertion order
+ *
+ *  i.e:
+ *      DHMAP_ITER_START(dhmap, char *, str) {
+ *          puts(str);
+ *      }
+ *      DHMAP_ITER_END(dhmap, char *, str)
+ */
+# define DHMAP_ITER_START(H, T, V)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->nentries ; __i++) {\
+        t_dhmap_entry * entry = (H)->entries + __i;\
+        if (entry->key != NULL) {\
+            T V = (T)(entry->data);
+# define DHMAP_ITER_END(H, T, V)\
+        }\
+    }\
+}
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef FHMAP_H
+# define FHMAP_H
+
+# include <stdint.h>
+# include "common.h"
+# include "hmap.h"
+
+/**
+ *  Frozen hash map: an immutable hash map, built from a 't_hmap' with 'hmap_freeze()'
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - a minimal perfect hash function is built for the keys (CHD: "compress, hash and displace"):
+ *        the keys are split in buckets of FHMAP_BUCKET_SIZE keys on average, and a seed is searched
+ *        for each bucket, so that every key of the map gets its own position in a table a bit bigger
+ *        than the number of values (filled at FHMAP_LOAD%: the last buckets still find a free
+ *        position in a few tries)
+ *      - the table is then compressed: the values placed after the last slot are moved in the free
+ *        slots, and a small array remaps their positions. There are as many slots as values: the memory
+ *        used is the slots (a key and a data pointer per value), plus a 32 bits seed per bucket,
+ *        plus the remap array (about (100 - FHMAP_LOAD)% of the values)
+ *      - a lookup costs a single probe (two for the few remapped values) and a single key comparison
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *
+ *  example for a string hashmap:
+ *
+ *      t_hmap * map = hmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      hmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      t_fhmap * frozen = hmap_freeze(map); //'map' is consumed
+ *      char *helloworld = fhmap_get(frozen, "ima key"); //now contains "Hello world"
+ */
+
+/** average number of keys per bucket of the perfect hash function (less buckets is less memory, but a slower build) */
+# ifndef FHMAP_BUCKET_SIZE
+#   define FHMAP_BUCKET_SIZE 4
+# endif
+
+/** percentage of the table positions holding a value (less is a faster build, but a bigger remap array) */
+# ifndef FHMAP_LOAD
+#   define FHMAP_LOAD 95
+# endif
+
+/** number of seeds tried for a bucket before the build fails */
+# ifndef FHMAP_MAX_SEED
+#   define FHMAP_MAX_SEED (1 << 24)
+# endif
+
+typedef struct  s_fhmap_slot {
+    void const * key; //the key used
+    void const * data; //the data holds
+}               t_fhmap_slot;
+
+typedef struct  s_fhmap {
+    uint32_t * seeds; //seed of each bucket
+    unsigned long int nbuckets; //number of buckets
+    t_fhmap_slot * slots; //the slots, one per value
+    unsigned long int npositions; //number of positions the perfect hash function gives (at least 'size')
+    unsigned long int * remap; //slot of the positions after the last slot ('remap[position - size]')
+    unsigned long int size; //number of value set
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where slot keys are sent as parameters
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_fhmap;
+
+/**
+ *  Freeze the hash map: build an immutable frozen map with its values.
+ *
+ *  On success, 'hmap' is deleted, and the frozen map owns its keys and data (it uses the same
+ *  'hashf', 'keycmpf', 'keyfreef' and 'datafreef'). If a key was inserted many times, only
+ *  the value returned by 'hmap_get()' is kept, and the others are freed.
+ *
+ *  return the frozen map, or NULL if it couldnt be built (and 'hmap' is left unchanged):
+ *  i.e, if two different keys have the same hash
+ */
+t_fhmap * hmap_freeze(t_hmap * hmap);
+
+/**
+ *  Delete the frozen map from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void fhmap_delete(t_fhmap * fhmap);
+
+/**
+ *  Get data from the frozen map, NULL if the key isnt found
+ */
+void * fhmap_get(t_fhmap * fhmap, void const * key);
+
+/**
+ *  Macro to iterate though to frozen map
+ *
+ *  i.e:
+ *      FHMAP_ITER_START(fhmap, char *, str) {
+ *          puts(str);
+ *      }
+ *      FHMAP_ITER_END(fhmap, char *, str)
+ */
+# define FHMAP_ITER_START(H, T, V)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->size ; __i++) {\
+        t_fhmap_slot * slot = (H)->slots + __i;\
+        T V = (T)(slot->data);
+# define FHMAP_ITER_END(H, T, V)\
+    }\
+}
+
+#endif
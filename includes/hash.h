@@ -0,0 +1,59 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef HASH_H
+# define HASH_H
+
+# include <stdint.h>
+# include "common.h"
+
+/**
+ *  Hash functions, to be used with the hash maps of this library
+ *
+ *  The hash maps choose a bucket from the low bits of the hash ('hash & (capacity - 1)'):
+ *  every bit of the result of these functions depends on every bit of the input,
+ *  so sequential keys are spread over the whole table.
+ *
+ *  i.e:
+ *      t_hmap * map = hmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      t_hmap * map = hmap_new(1024, (t_hf)u64hash, (t_cmpf)u64cmp, free, free);
+ */
+
+/**
+ *  Hash 'size' bytes, reading them 8 by 8 (wyhash algorithm: https://github.com/wangyi-fudan/wyhash).
+ *  'seed' selects a different hash function: use a random one if the keys may be chosen by an attacker.
+ */
+unsigned long int hash_bytes(void const * data, unsigned long int size, unsigned long int seed);
+
+/**
+ *  Hash a string (see 'hash_bytes()')
+ */
+unsigned long int strhash_seeded(char const * str, unsigned long int seed);
+
+/**
+ *  Mix the bits of an integer (bijective: different integers never collide)
+ */
+unsigned long int hash_u32(uint32_t value);
+unsigned long int hash_u64(uint64_t value);
+
+/**
+ *  Hash functions for keys pointing to integers, and for pointers keys
+ */
+unsigned long int u32hash(uint32_t const * key);
+unsigned long int u64hash(uint64_t const * key);
+unsigned long int ptrhash(void const * ptr);
+
+/**
+ *  Comparison functions for keys pointing to integers, and for pointers keys
+ */
+int u32cmp(uint32_t const * a, uint32_t const * b);
+int u64cmp(uint64_t const * a, uint64_t const * b);
+int ptrcmp(void const * a, void const * b);
+
+#endif
@@ -11,7 +11,9 @@
 # define HMAP_H
 
 # include "common.h"
+# include "hash.h"
 # include "list.h"
+# include "bitmap.h"
 
 /**
  *  Generic hash map implementation in C89:
@@ -20,6 +22,14 @@
  *      - given pointer address are saved for values. No copy their data are done. (same for keys)
  *      - const where used where on constant data (well...), so you dont mess up the hash map :)
  *      - an array of linked list is used to handle collisions
+ *      - the number of lists grows (and shrinks) with the load factor. The resize is incremental:
+ *        the nodes of the old lists are migrated a few buckets at a time on each
+ *        'hmap_insert()', 'hmap_get()' and 'hmap_remove_key()' call, so no call pays for a full rehash
+ *      - the key hash is saved in the node, and compared before calling the key comparison function
+ *      - optionally, short keys are copied inside the node (see 'hmap_inline_keys()'), so comparing
+ *        them doesnt dereference the key pointer
+ *      - optionally, a blocked bloom filter of the key hashes is tested before the lists
+ *        (see 'hmap_bloom_filter()'), so most searches of missing keys read a single cache line
  *
  * 
  *  example for a string hashmap:
@@ -29,6 +39,76 @@
  *      char *helloworld = hmap_get(&map, "ima key"); //now contains "Hello world"
  */
  
+/** minimum number of lists of a hash map */
+# ifndef HMAP_MIN_CAPACITY
+#   define HMAP_MIN_CAPACITY 8
+# endif
+
+/** the map grows when it holds more than 'capacity * HMAP_MAX_LOAD' values */
+# ifndef HMAP_MAX_LOAD
+#   define HMAP_MAX_LOAD 1
+# endif
+
+/** the map shrinks when it holds less than 'capacity / HMAP_SHRINK_RATIO' values */
+# ifndef HMAP_SHRINK_RATIO
+#   define HMAP_SHRINK_RATIO 8
+# endif
+
+/** number of non-empty old lists migrated on each operation while resizing */
+# ifndef HMAP_REHASH_STEP
+#   define HMAP_REHASH_STEP 4
+# endif
+
+/** maximum size in bytes of a key copied inside its node (see 'hmap_inline_keys()') */
+# ifndef HMAP_INLINE_KEY_SIZE
+#   define HMAP_INLINE_KEY_SIZE 24
+# endif
+
+/** number of keys hashed and prefetched together by 'hmap_get_batch()' and 'hmap_insert_batch()' */
+# ifndef HMAP_BATCH_SIZE
+#   define HMAP_BATCH_SIZE 16
+# endif
+
+/** maximum number of threads used by 'hmap_build_from_arrays()' */
+# ifndef HMAP_BUILD_MAX_THREADS
+#   define HMAP_BUILD_MAX_THREADS 256
+# endif
+
+/** number of partitions of the values in 'hmap_build_from_arrays()' (a power of two) */
+# ifndef HMAP_BUILD_PARTITIONS
+#   define HMAP_BUILD_PARTITIONS 1024
+# endif
+
+/** number of chain lengths counted by 'hmap_stats()' (the last one counts every longer chain) */
+# ifndef HMAP_STATS_HISTOGRAM
+#   define HMAP_STATS_HISTOGRAM 16
+# endif
+
+/** bits of the bloom filter per value (see 'hmap_bloom_filter()'): 10 gives about 1% of false positives */
+# ifndef HMAP_BLOOM_BITS
+#   define HMAP_BLOOM_BITS 10
+# endif
+
+/** bits set per value, in the value block of the bloom filter (at most 7) */
+# ifndef HMAP_BLOOM_HASHES
+#   define HMAP_BLOOM_HASHES 7
+# endif
+
+/**
+ *  Define HMAP_STATS (i.e, '-D HMAP_STATS', for the library and the programs using it) to count
+ *  the operations of every map (see 'hmap_stats()'). It is compiled out by default.
+ */
+typedef struct  s_hmap_counters {
+    unsigned long int hits; //number of key searches which found the key
+    unsigned long int misses; //number of key searches which didnt find the key
+    unsigned long int hit_probes; //number of nodes visited by the searches which found the key
+    unsigned long int miss_probes; //number of nodes visited by the searches which didnt find the key
+    unsigned long int inserts; //number of values inserted
+    unsigned long int removes; //number of values removed
+    unsigned long int resizes; //number of resizes started
+    unsigned long int filtered; //number of key searches rejected by the bloom filter (also counted in 'misses')
+}               t_hmap_counters;
+
 typedef struct  s_hmap_node {
     unsigned long int const hash; //hash of the key
     void const * data; //the data holds
@@ -39,16 +119,47 @@ typedef struct  s_hmap {
     t_list * values; //a buffer of value holders (to handle collision)
     unsigned long int capacity; //number of lists
     unsigned long int size; //number of value set
+    t_list * old_values; //lists being migrated into 'values' while resizing, NULL elseway
+    unsigned long int old_capacity; //number of lists in 'old_values'
+    unsigned long int rehash_index; //next list of 'old_values' to migrate
+    unsigned long int min_capacity; //the map never shrinks below this capacity
     t_hash_function hashf; //hash function
     t_cmp_function keycmpf; //key comparison function, where node keys are sent as parameters
     t_function datafreef; //function call when a data object should be freed
     t_function keyfreef; //function called when a key should be freed
+    t_size_function keysizef; //if set, returns the size of a key, and short keys are copied after the nodes
+    struct s_hmap * dataindex; //if set, maps each data pointer to its node (see 'hmap_index_data()')
+    t_bitmap * bloom; //if set, bloom filter of the key hashes (see 'hmap_bloom_filter()')
+    unsigned long int bloom_blocks; //number of blocks of the bloom filter (a power of two)
+    unsigned long int bloom_offset; //index of the first bit of the bloom filter, so blocks start on a cache line
+    unsigned long int bloom_capacity; //number of hashes the bloom filter holds before it is rebuilt
+    unsigned long int bloom_count; //number of hashes added to the bloom filter (removed values included)
+    void * slab; //block holding the nodes and list heads of 'hmap_build_from_arrays()' (never freed one by one), NULL elseway
+    unsigned long int slab_size; //size in bytes of 'slab'
+# ifdef HMAP_STATS
+    t_hmap_counters counters; //operations counters
+# endif
 }               t_hmap;
 
+typedef struct  s_hmap_stats {
+    unsigned long int size; //number of value set
+    unsigned long int lists; //number of lists (including the old lists not migrated yet, while resizing)
+    double load_factor; //values per list
+    unsigned long int chains[HMAP_STATS_HISTOGRAM]; //'chains[i]' is the number of lists of 'i' values
+    unsigned long int longest_chain; //number of values of the longest list
+    double empty_ratio; //part of the lists which are empty
+    double probes_per_hit; //nodes visited to find a key of the map, on average (every key searched as often)
+    double probes_per_miss; //nodes visited to search a key which isnt in the map, on average (missing keys hashed as the keys of the map)
+    unsigned long int bytes; //memory used by the map (lists, nodes, data index and bloom filter, not the keys and data)
+    int counting; //1 if the counters below are set (HMAP_STATS is defined), 0 elseway
+    t_hmap_counters counters; //operations counters, since the map was created
+}               t_hmap_stats;
+
 /**
  *  Create a new hashmap:
  *
- *  capacity : capacity of the hashmap (number of lists boxes in memory)
+ *  capacity : initial capacity of the hashmap (number of lists boxes in memory),
+ *             rounded to the next power of two. The map never shrinks below it.
  *  hashf    : hash function to use on inserted elements
  *  cmpf     : comparison function to use when searching a data
  */
@@ -77,6 +188,94 @@ void hmap_delete(t_hmap * hmap);
  */
 void const * hmap_insert(t_hmap * hmap, void const * data, void const * key);
 
+/**
+ *  Same as 'hmap_insert()', but return the node of the value: a handle to remove it
+ *  in constant time with 'hmap_remove_node()'. The node stays valid until it is removed,
+ *  even if the map resizes. Return NULL if the value wasnt inserted.
+ */
+t_hmap_node * hmap_insert_handle(t_hmap * hmap, void const * data, void const * key);
+
+/**
+ *  Same as 'hmap_insert()', with the already computed hash of the key ('hmap->hashf(key)')
+ */
+void const * hmap_insert_hashed(t_hmap * hmap, void const * data, void const * key, unsigned long int hash);
+
+/**
+ *  Insert 'n' values into the hashmap: 'datas[i]' is inserted with the key 'keys[i]'.
+ *  The keys are hashed and their lists prefetched by groups, so the cache misses overlap.
+ *
+ *  return the number of values inserted
+ */
+unsigned long int hmap_insert_batch(t_hmap * hmap, void const ** datas, void const ** keys, unsigned long int n);
+
+/**
+ *  Get the data of the key, or insert the given value if the key isnt found.
+ *  The key is hashed and its list walked only once.
+ *
+ *  return the data of the key: 'data' if it was inserted (the map then owns 'data' and 'key'),
+ *  the data already in the map elseway (and 'data' and 'key' are left to the caller).
+ *  NULL if the value couldnt be inserted
+ */
+void * hmap_get_or_insert(t_hmap * hmap, void const * data, void const * key);
+
+/**
+ *  Same as 'hmap_get_or_insert()', but return the node of the key: the node of the new value
+ *  if 'data' was inserted ('node->data' is then 'data'), the node already in the map elseway.
+ *  NULL if the value couldnt be inserted
+ */
+t_hmap_node * hmap_get_or_insert_handle(t_hmap * hmap, void const * data, void const * key);
+
+/**
+ *  Insert the value, or replace the value of the key if it is already in the map:
+ *  the old data and key are freed with 'datafreef' and 'keyfreef', and the node (and its handle) is kept.
+ *  The key is hashed and its list walked only once.
+ *
+ *  return the given data if it was set properly, NULL elseway
+ */
+void const * hmap_upsert(t_hmap * hmap, void const * data, void const * key);
+
+/**
+ *  Update the data of a key in place, hashing the key and walking its list only once:
+ *
+ *  updatef : called as 'updatef(data, param)', with the data of the key, or NULL if the key isnt found.
+ *            It returns the new data of the key (which may be the same pointer, modified in place).
+ *            If the key wasnt found, the returned data is inserted with 'key' (the map then owns 'key'),
+ *            unless it is NULL. If the returned data replaces another one, the old one is freed with 'datafreef'.
+ *            If the key was found and NULL is returned, the key is removed from the map (its old data and
+ *            key are freed with 'datafreef' and 'keyfreef', so 'updatef' must not free the old data itself).
+ *
+ *  i.e, to count words:
+ *      void * count(void * n, void * param) {
+ *          if (n == NULL) {
+ *              n = calloc(1, sizeof(int));
+ *          }
+ *          ++*(int *)n;
+ *          return (n);
+ *      }
+ *      hmap_update(map, word, count, NULL);
+ *
+ *  return the data of the key after the update (NULL if there is none, or if it couldnt be inserted:
+ *  the data returned by 'updatef' is then freed with 'datafreef', and the key keeps its old data)
+ */
+void * hmap_update(t_hmap * hmap, void const * key, t_update_function updatef, void * param);
+
+/**
+ *  Build a hash map holding 'n' values: 'datas[i]' is inserted with the key 'keys[i]'
+ *  (as 'hmap_insert_batch()' on a new map would, duplicated keys included). Link with -lpthread.
+ *
+ *  threads : number of threads used (1 to build in the calling thread only, at most HMAP_BUILD_MAX_THREADS)
+ *  hashf, keycmpf, keyfreef, datafreef : as for 'hmap_new()'
+ *
+ *  The keys are hashed in parallel, the values partitioned by ranges of lists (a radix pass on the
+ *  list index), and each partition is linked by a single thread, without locking.
+ *  Every node and list head is allocated in a single block (the map slab): no allocation is done
+ *  per value. The nodes of the slab are only released when the map is deleted.
+ *
+ *  return the new map, NULL if there isnt enough memory
+ */
+t_hmap * hmap_build_from_arrays(void const ** keys, void const ** datas, unsigned long int n, unsigned int threads,
+                                t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
 /**
  *  Get data from the hashmap
  *
@@ -85,14 +284,47 @@ void const * hmap_insert(t_hmap * hmap, void const * data, void const * key);
  */
 void * hmap_get(t_hmap * hmap, void const * key);
 
+/**
+ *  Same as 'hmap_get()', with the already computed hash of the key ('hmap->hashf(key)')
+ */
+void * hmap_get_hashed(t_hmap * hmap, void const * key, unsigned long int hash);
+
+/**
+ *  Same as 'hmap_get_hashed()', but no list is migrated if the map is resizing:
+ *  the map isnt modified, so lookups can run concurrently (i.e, under a read lock)
+ */
+void * hmap_lookup_hashed(t_hmap * hmap, void const * key, unsigned long int hash);
+
+/**
+ *  Get the data of 'n' keys: 'datas[i]' is set to the data of 'keys[i]', or NULL if it isnt found.
+ *  The keys are hashed and their lists prefetched by groups, so the cache misses overlap.
+ *
+ *  return the number of keys found
+ */
+unsigned long int hmap_get_batch(t_hmap * hmap, void const ** keys, void ** datas, unsigned long int n);
+
 /**
  *  Remove the data pointer from the hash map
  *  return 1 if the element was removed, 0 elseway
  *  hmap : the hash map
  *  data : pointer to the data
+ *
+ *  Every list is searched, unless the data are indexed (see 'hmap_index_data()')
  */
 int hmap_remove_data(t_hmap * hmap, void const * data);
 
+/**
+ *  Index the nodes by their data pointer, so 'hmap_remove_data()' runs in constant time.
+ *  The index costs an entry for each value, and is kept up to date by the insertions / removals.
+ *  return 1 if the index was built, 0 elseway
+ */
+int hmap_index_data(t_hmap * hmap);
+
+/**
+ *  Remove the node returned by 'hmap_insert_handle()' from the hash map, in constant time
+ */
+void hmap_remove_node(t_hmap * hmap, t_hmap_node * node);
+
 /**
  *  Remove the data which match with the given key from the hash map
  *  return 1 if the element was removed, 0 elseway
@@ -103,13 +335,72 @@ int hmap_remove_data(t_hmap * hmap, void const * data);
 int hmap_remove_key(t_hmap * hmap, void const * key);
 
 /**
- *  Some simple builtin hashes functions, useful for tests.
+ *  Same as 'hmap_remove_key()', with the already computed hash of the key ('hmap->hashf(key)')
+ */
+int hmap_remove_key_hashed(t_hmap * hmap, void const * key, unsigned long int hash);
+
+/**
+ *  Copy short keys inside the hash map nodes: keys comparison wont dereference the key pointers anymore.
+ *  The map must be empty. Return 1 on success, 0 elseway.
+ *
+ *  hmap     : the hash map
+ *  keysizef : function returning the size in bytes of a key (i.e: 'strlen(key) + 1' for strings).
+ *             Keys up to HMAP_INLINE_KEY_SIZE bytes are copied, and the copy is sent to 'keycmpf',
+ *             so keys should be comparable once copied (no pointer to themselves).
+ *             The given key pointers are still the ones saved in the nodes, and sent to 'keyfreef'.
+ *             Each node is then followed by the size of its key copy (0 if the key is too long) and the copy;
+ *             the nodes of the other maps keep their size.
+ *
+ *  i.e, for a string hashmap:
+ *      hmap_inline_keys(map, (t_sf)strsize);
+ */
+int hmap_inline_keys(t_hmap * hmap, t_size_function keysizef);
+
+/**
+ *  Add a bloom filter in front of the lists, for maps where most searched keys are missing.
+ *  return 1 if the filter was built, 0 elseway
+ *
+ *  The filter is split in blocks of a cache line: the HMAP_BLOOM_HASHES bits of a key are all set in
+ *  the same block, so a search tests one cache line, and most missing keys are rejected without
+ *  walking their list. Bits cant be unset: the hashes of removed values stay in the filter until it
+ *  is rebuilt, which happens once it holds too many hashes (values added), or once half of its
+ *  capacity is used by removed values.
+ *
+ *  i.e:
+ *      hmap_bloom_filter(map);
+ *      hmap_get(map, "missing key"); //usually returns NULL without reading any list
+ */
+int hmap_bloom_filter(t_hmap * hmap);
+
+/**
+ *  Get statistics about the map, to find undersized maps and poor hash functions:
+ *  the chain lengths are read from the lists (which costs a walk over the whole map),
+ *  and the operations counters are copied if HMAP_STATS is defined.
  *
- *  String hash is based on : http://www.cse.yorku.ca/~oz/hash.html
+ *  i.e, a good hash function gives a 'probes_per_hit' close to '1 + load_factor / 2',
+ *  and a 'probes_per_miss' close to '1 + load_factor'
+ */
+void hmap_stats(t_hmap * hmap, t_hmap_stats * stats);
+
+/**
+ *  Write the statistics in a readable form to the given file (i.e, 'stderr')
+ */
+void hmap_stats_print(t_hmap_stats const * stats, FILE * file);
+
+/**
+ *  Some simple builtin hashes functions (see 'hash.h' for more)
+ *
+ *  strhash : 'strhash_seeded()' with a seed of 0
+ *  inthash : 'hash_u32()'
  */
 unsigned long int strhash(char const * str);
 unsigned long int inthash(int const value);
 
+/**
+ *  Size of a string key, including its '\0' (to be used with 'hmap_inline_keys()')
+ */
+unsigned long int strsize(char const * str);
+
 /**
  *  Macro to iterate fastly though to hash map
  *
@@ -121,17 +412,22 @@ unsigned long int inthash(int const value);
  */
 # define HMAP_ITER_START(H, T, V)\
 {\
-    unsigned long int i = 0;\
-    while (i < (H)->capacity) {\
-        t_list * lst = (H)->values + i;\
-        if (lst != NULL && lst->head != NULL) {\
-            LIST_ITER_START(lst, t_hmap_node *, node) {\
-                T V = (T)(node->data);
+    t_list * __tables[2] = {(H)->values, (H)->old_values};\
+    unsigned long int __capacities[2] = {(H)->capacity, (H)->old_capacity};\
+    int __table;\
+    for (__table = 0 ; __table < 2 ; __table++) {\
+        unsigned long int i = 0;\
+        while (__tables[__table] != NULL && i < __capacities[__table]) {\
+            t_list * lst = __tables[__table] + i;\
+            if (lst->head != NULL) {\
+                LIST_ITER_START(lst, t_hmap_node *, node) {\
+                    T V = (T)(node->data);
 # define HMAP_ITER_END(H, T, V)\
+                }\
+                LIST_ITER_END(lst, t_hmap_node *, node)\
             }\
-            LIST_ITER_END(lst, t_hmap_node *, node)\
+            ++i;\
         }\
-        ++i;\
     }\
 }
 
@@ -0,0 +1,127 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef HSNAP_H
+# define HSNAP_H
+
+# include <stdint.h>
+# include "common.h"
+# include "hmap.h"
+
+/**
+ *  Hash map snapshots: a 't_hmap' is saved to a file with 'hsnap_save()', and the file is mapped
+ *  in memory with 'hsnap_open()'. It can then be queried straight away: nothing is read
+ *  or rebuilt, the pages are loaded by the system when they are first accessed.
+ *
+ *  ABOUT THE FILE FORMAT:
+ *      - a header, then the buckets, then the entries, then the keys and data bytes
+ *      - every reference is an offset from the start of the file, so it can be mapped at any address
+ *      - the entries of a bucket are contiguous: 'buckets[b]' is the first entry of the bucket 'b',
+ *        and 'buckets[b + 1]' the end of it
+ *      - each entry holds the key hash, so lookups compare hashes before comparing keys
+ *      - numbers are saved in the byte order of the machine
+ *
+ *  Keys and data are copied byte per byte: they should hold no pointers (i.e, strings, structures of
+ *  numbers...). The hash function must give the same hashes in every process ('strhash()' does,
+ *  'ptrhash()' does not).
+ *
+ *  example for a string hashmap:
+ *
+ *      hsnap_save(map, "map.snap", (t_sf)strsize, (t_sf)strsize);
+ *      ...
+ *      t_hsnap * snap = hsnap_open("map.snap", (t_hf)strhash, (t_cmpf)strcmp);
+ *      char const * helloworld = hsnap_get(snap, "ima key");
+ */
+
+/** first bytes of a snapshot file, and version of the format */
+# define HSNAP_MAGIC "HMAPSNAP"
+# define HSNAP_VERSION 1
+
+typedef struct  s_hsnap_header {
+    char magic[8]; //HSNAP_MAGIC
+    uint32_t version; //HSNAP_VERSION
+    uint32_t entry_size; //sizeof(t_hsnap_entry)
+    uint64_t nbuckets; //number of buckets (a power of two)
+    uint64_t size; //number of entries
+    uint64_t buckets; //offset of the buckets (nbuckets + 1 entry indices)
+    uint64_t entries; //offset of the entries
+    uint64_t file_size; //size of the whole file
+}               t_hsnap_header;
+
+typedef struct  s_hsnap_entry {
+    uint64_t hash; //hash of the key
+    uint64_t key; //offset of the key bytes
+    uint64_t key_size; //number of key bytes
+    uint64_t data; //offset of the data bytes
+    uint64_t data_size; //number of data bytes
+}               t_hsnap_entry;
+
+typedef struct  s_hsnap {
+    BYTE const * base; //the mapped file
+    t_hsnap_header const * header; //the file header
+    uint64_t const * buckets; //the file buckets
+    t_hsnap_entry const * entries; //the file entries
+    unsigned long int size; //number of value set
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where mapped keys are sent as parameters
+}               t_hsnap;
+
+/**
+ *  Save the hash map in a snapshot file
+ *
+ *  hmap      : the hash map
+ *  path      : the file to write
+ *  keysizef  : function returning the size in bytes of a key (i.e, 'strsize()')
+ *  datasizef : function returning the size in bytes of a data
+ *
+ *  return 1 if the file was written, 0 elseway
+ */
+int hsnap_save(t_hmap * hmap, char const * path, t_size_function keysizef, t_size_function datasizef);
+
+/**
+ *  Map a snapshot file in memory, read only
+ *
+ *  path    : the file written by 'hsnap_save()'
+ *  hashf   : the hash function of the saved map
+ *  keycmpf : comparison function to use when searching a data
+ *
+ *  return the snapshot, or NULL if the file couldnt be mapped, or isnt a valid snapshot
+ */
+t_hsnap * hsnap_open(char const * path, t_hash_function hashf, t_cmp_function keycmpf);
+
+/**
+ *  Unmap the snapshot (the pointers returned by 'hsnap_get()' are no longer valid)
+ */
+void hsnap_close(t_hsnap * hsnap);
+
+/**
+ *  Get data from the snapshot (a pointer in the mapped file), NULL if the key isnt found
+ */
+void const * hsnap_get(t_hsnap * hsnap, void const * key);
+
+/**
+ *  Macro to iterate though the snapshot ('entry' is the current entry)
+ *
+ *  i.e:
+ *      HSNAP_ITER_START(hsnap, char const *, str) {
+ *          puts(str);
+ *      }
+ *      HSNAP_ITER_END(hsnap, char const *, str)
+ */
+# define HSNAP_ITER_START(H, T, V)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->size ; __i++) {\
+        t_hsnap_entry const * entry = (H)->entries + __i;\
+        T V = (T)((H)->base + entry->data);
+# define HSNAP_ITER_END(H, T, V)\
+    }\
+}
+
+#endif
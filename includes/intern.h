@@ -0,0 +1,101 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef INTERN_H
+# define INTERN_H
+
+# include "common.h"
+# include "hmap.h"
+
+/**
+ *  String interning pool: each distinct string is stored once, and the pool returns
+ *  a canonical pointer to it, which stays valid until the pool is deleted.
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - the strings are copied in an arena: big chunks of memory filled one after the other,
+ *        so interning a new string does no allocation (but once per chunk), and deleting the pool
+ *        frees the chunks only
+ *      - the hash and the length of a string are stored right before it: interned strings
+ *        are hashed without reading them (see 'intern_hash()'), and compared by pointer
+ *        (see 'intern_cmp()'). 'intern_hash()' is equal to 'strhash()'
+ *      - a 't_hmap' finds the interned strings
+ *
+ *  example, with a hash map whose keys are interned strings:
+ *
+ *      t_intern * pool = intern_new(1024);
+ *      t_hmap * map = hmap_new(1024, (t_hf)intern_hash, (t_cmpf)intern_cmp, NULL, free);
+ *      hmap_insert(map, strdup("Hello world"), intern_string(pool, "ima key"));
+ *      char *helloworld = hmap_get(map, intern_string(pool, "ima key")); //now contains "Hello world"
+ *      hmap_delete(map);
+ *      intern_delete(pool); //every interned string is freed
+ */
+
+/** size in bytes of the arena chunks (longer strings get a chunk of their own) */
+# ifndef INTERN_CHUNK_SIZE
+#   define INTERN_CHUNK_SIZE (64 * 1024)
+# endif
+
+/** header of an interned string, stored right before its characters */
+typedef struct  s_intern_string {
+    unsigned long int hash; //hash of the string ('strhash()')
+    unsigned long int length; //length of the string, without its '\0'
+}               t_intern_string;
+
+typedef struct  s_intern_chunk {
+    struct s_intern_chunk * next; //the previous chunk filled
+    unsigned long int size; //size in bytes of the chunk memory (following this header)
+    unsigned long int used; //bytes of the chunk memory used
+}               t_intern_chunk;
+
+typedef struct  s_intern {
+    t_hmap * hmap; //the interned strings, with themselves as key
+    t_intern_chunk * chunks; //the chunk being filled, followed by the full ones
+    unsigned long int bytes; //bytes of the interned strings (with their header)
+}               t_intern;
+
+/**
+ *  Create a new pool
+ *
+ *  capacity : number of strings the pool should hold before growing
+ */
+t_intern * intern_new(unsigned long int capacity);
+
+/**
+ *  Delete the pool: every interned string is freed
+ */
+void intern_delete(t_intern * pool);
+
+/**
+ *  Intern the string: return its canonical copy (the first one interned), NULL if there isnt enough memory
+ */
+char const * intern_string(t_intern * pool, char const * str);
+
+/**
+ *  Same as 'intern_string()', for the 'length' first bytes of 'str' (which doesnt need to end with a '\0':
+ *  i.e, a token in a parsed buffer)
+ */
+char const * intern_bytes(t_intern * pool, char const * str, unsigned long int length);
+
+/**
+ *  Return the canonical copy of the string, NULL if it wasnt interned
+ */
+char const * intern_get(t_intern * pool, char const * str);
+
+/**
+ *  Hash and length of an interned string, read from its header
+ */
+unsigned long int intern_hash(char const * str);
+unsigned long int intern_length(char const * str);
+
+/**
+ *  Compare two interned strings (as 'strcmp()' would for their equality): their pointers are compared
+ */
+int intern_cmp(char const * a, char const * b);
+
+#endif
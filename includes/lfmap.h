@@ -0,0 +1,112 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef LFMAP_H
+# define LFMAP_H
+
+# include <stdatomic.h>
+# include <stdint.h>
+# include "common.h"
+
+/**
+ *  Lock-free hash map (C11 atomics), for read-dominated concurrent workloads
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - split-ordered list (Shalev & Shavit): every value is in a single sorted linked list,
+ *        ordered by the bit-reversed hash of its key. The buckets are shortcuts to 'dummy' nodes
+ *        of this list, so doubling the number of buckets never moves a node.
+ *      - buckets are initialized lazily, on the first insertion / removal which needs them
+ *      - 'lfmap_get()' does no atomic write: it only reads the list
+ *      - 'lfmap_insert()' and 'lfmap_remove_key()' use compare-and-swap (Harris-Michael list).
+ *        A removed node is first marked, then unlinked.
+ *      - unlinked nodes cant be freed while another thread may still read them: they are kept
+ *        until 'lfmap_reclaim()' or 'lfmap_delete()' is called. 'keyfreef' and 'datafreef'
+ *        are called at that time, so a data returned by 'lfmap_get()' stays valid until then.
+ *      - unlike 'hmap_insert()', 'lfmap_insert()' doesnt insert a key twice
+ *
+ *  example for a string hashmap:
+ *
+ *      t_lfmap * map = lfmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      lfmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      char *helloworld = lfmap_get(map, "ima key"); //now contains "Hello world"
+ */
+
+/** the number of buckets doubles when the map holds more than 'buckets * LFMAP_MAX_LOAD' values */
+# ifndef LFMAP_MAX_LOAD
+#   define LFMAP_MAX_LOAD 2
+# endif
+
+/** the bucket directory is made of segments of 1, 1, 2, 4, 8 ... buckets, allocated on demand */
+# define LFMAP_SEGMENTS 64
+
+typedef struct  s_lfmap_node {
+    unsigned long int so_key; //split order key: reversed hash, odd for values, even for dummy nodes
+    void const * key; //the key used (NULL for dummy nodes)
+    void const * data; //the data holds
+    _Atomic(uintptr_t) next; //next node of the list, lowest bit set if this node is removed
+    struct s_lfmap_node * retired; //next node waiting to be freed, once unlinked
+}               t_lfmap_node;
+
+typedef _Atomic(t_lfmap_node *) t_lfmap_bucket;
+
+typedef struct  s_lfmap {
+    _Atomic(t_lfmap_bucket *) segments[LFMAP_SEGMENTS]; //bucket directory
+    _Atomic(unsigned long int) nbuckets; //number of buckets used (a power of two)
+    _Atomic(unsigned long int) size; //number of value set
+    _Atomic(t_lfmap_node *) retired; //unlinked nodes, freed by 'lfmap_reclaim()'
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where node keys are sent as parameters
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_lfmap;
+
+/**
+ *  Create a new lock-free hashmap:
+ *
+ *  capacity : number of values the map should hold before growing
+ *  hashf    : hash function to use on inserted elements
+ *  keycmpf  : comparison function to use when searching a data
+ *  keyfreef, datafreef : see 'hmap_new()'
+ */
+t_lfmap * lfmap_new(unsigned long int capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the hashmap from the heap (no other thread should use it anymore)
+ */
+void lfmap_delete(t_lfmap * lfmap);
+
+/**
+ *  Insert a value into the hashmap
+ *  return the given data if it was inserted, NULL if the key was already set (or not enough memory)
+ */
+void const * lfmap_insert(t_lfmap * lfmap, void const * data, void const * key);
+
+/**
+ *  Get data from the hashmap, NULL if the key isnt found
+ */
+void * lfmap_get(t_lfmap * lfmap, void const * key);
+
+/**
+ *  Remove the data which match with the given key from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int lfmap_remove_key(t_lfmap * lfmap, void const * key);
+
+/**
+ *  Free the removed nodes (and call 'keyfreef' / 'datafreef' on them).
+ *  No other thread should use the map during this call.
+ */
+void lfmap_reclaim(t_lfmap * lfmap);
+
+/**
+ *  Number of values in the hashmap
+ */
+unsigned long int lfmap_size(t_lfmap * lfmap);
+
+#endif
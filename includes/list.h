@@ -60,6 +60,22 @@ int list_remove(t_list * lst, t_cmp_function cmpf, void * cmpref);
  */
 void list_remove_node(t_list * lst, t_list_node *node);
 
+/**
+ *	unlink the given node from the list, without freeing it
+ */
+void list_unlink_node(t_list * lst, t_list_node * node);
+
+/**
+ *	link an already allocated node (see 'list_unlink_node()') at the end of the list
+ */
+void list_add_node(t_list * lst, t_list_node * node);
+
+/**
+ *	link an already allocated node right before the node 'next' of the list
+ *	('next' may be the list head, to link it at the end of the list)
+ */
+void list_add_node_before(t_list * lst, t_list_node * next, t_list_node * node);
+
 /**
  * Remove first / last element of the list. Return 1 if it was removed, 0 else
  */
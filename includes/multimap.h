@@ -0,0 +1,123 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef MULTIMAP_H
+# define MULTIMAP_H
+
+# include "common.h"
+# include "hmap.h"
+# include "array.h"
+
+/**
+ *  Multimap: a hash map where a key holds many values
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - a 't_hmap' maps each key (stored once) to a 't_array' of its values: the values of a key
+ *        are contiguous, and 'multimap_get_all()' returns them with a single lookup
+ *      - adding a value to a key already in the map allocates no node: the value is appended
+ *        to the key array (which grows from time to time)
+ *      - the values of a key are kept in insertion order
+ *
+ *  example for a string multimap:
+ *
+ *      t_multimap * map = multimap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      multimap_insert(map, strdup("Hello"), strdup("ima key"));
+ *      multimap_insert(map, strdup("world"), strdup("ima key")); //this key copy is freed: the first one is kept
+ *      t_multimap_span span = multimap_get_all(map, "ima key"); //span.size is 2: "Hello" and "world"
+ */
+
+/** initial capacity of the array of values of a key (at least 1) */
+# ifndef MULTIMAP_VALUES_CAPACITY
+#   define MULTIMAP_VALUES_CAPACITY 2
+# endif
+
+typedef struct  s_multimap {
+    t_hmap * hmap; //map of the keys to their array of values (it owns the keys)
+    unsigned long int size; //number of values set (for every keys)
+    t_array * spare; //empty array of values, given to the next new key (so an insertion on a key found doesnt allocate)
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_multimap;
+
+typedef struct  s_multimap_span {
+    void ** values; //the values of the key, in insertion order (NULL if the key isnt found)
+    unsigned long int size; //number of values
+}               t_multimap_span;
+
+/**
+ *  Create a new multimap:
+ *
+ *  capacity : capacity of the multimap (number of keys it holds before growing)
+ *  hashf    : hash function to use on keys
+ *  keycmpf  : comparison function to use when searching a key
+ */
+t_multimap * multimap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf,
+                          t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the multimap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void multimap_delete(t_multimap * map);
+
+/**
+ *  Add a value to the key values.
+ *  If the key is already in the map, the stored key is kept, and the given key is freed with 'keyfreef'
+ *  (unless it is the stored key pointer).
+ *
+ *  return the given data if it was inserted properly, NULL elseway (the data and key are then left to the caller)
+ */
+void const * multimap_insert(t_multimap * map, void const * data, void const * key);
+
+/**
+ *  Get every value of the key (a span of size 0 if the key isnt found).
+ *  The span is valid until the next insertion or removal on this key.
+ */
+t_multimap_span multimap_get_all(t_multimap * map, void const * key);
+
+/**
+ *  Get the first value of the key, NULL if the key isnt found
+ */
+void * multimap_get(t_multimap * map, void const * key);
+
+/**
+ *  Remove the data pointer from the key values (the key is removed with its last value)
+ *  return 1 if the element was removed, 0 elseway
+ */
+int multimap_remove_data(t_multimap * map, void const * key, void const * data);
+
+/**
+ *  Remove the key and every of its values from the multimap
+ *  return the number of values removed
+ */
+unsigned long int multimap_remove_key(t_multimap * map, void const * key);
+
+/**
+ *  Macro to iterate though every value of the multimap ('key' is the key of the value)
+ *
+ *  i.e:
+ *      MULTIMAP_ITER_START(map, char *, str) {
+ *          printf("%s : %s\n", (char *)key, str);
+ *      }
+ *      MULTIMAP_ITER_END(map, char *, str)
+ */
+# define MULTIMAP_ITER_START(M, T, V)\
+{\
+    HMAP_ITER_START((M)->hmap, t_array *, __values) {\
+        void const * key = node->key;\
+        unsigned long int __j;\
+        for (__j = 0 ; __j < __values->size ; __j++) {\
+            T V = (T)(((void **)__values->values)[__j]);
+# define MULTIMAP_ITER_END(M, T, V)\
+        }\
+    }\
+    HMAP_ITER_END((M)->hmap, t_array *, __values)\
+}
+
+#endif
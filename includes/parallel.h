@@ -0,0 +1,50 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef PARALLEL_H
+# define PARALLEL_H
+
+# include <stddef.h>
+
+/**
+ *  Internal helpers of the parallel algorithms of this library ('hmap_build_from_arrays()',
+ *  'array_sort_parallel()'), which run in phases: every thread handles a range of the values
+ *  (or takes work from a shared counter), and the calling thread waits for all of them
+ *  before starting the next phase. Link with -lpthread.
+ */
+
+/** maximum number of threads created by a phase (the other ranges are run by the calling thread) */
+# ifndef PARALLEL_MAX_THREADS
+#   define PARALLEL_MAX_THREADS 256
+# endif
+
+/** a phase: called once for every thread index, with the state of the algorithm */
+typedef void (*t_parallel_phase)(void * state, unsigned int thread);
+
+/**
+ *  First index of the range of the thread, when 'n' values are split into 'threads' ranges
+ *  ('thread == threads' gives the end of the last range, 'n')
+ */
+size_t parallel_from(size_t n, unsigned int threads, unsigned int thread);
+
+/**
+ *  Run the phase for every thread index of [0, threads[ (index 0 on the calling thread),
+ *  and wait for them. The ranges of the threads which couldnt be created are run by the calling thread.
+ */
+void parallel_run(void * state, unsigned int threads, t_parallel_phase phase);
+
+/**
+ *  Prefix sums of the per thread counts: 'counts[t * nbuckets + b]' is the number of values of the
+ *  thread 't' in the bucket 'b'. It is replaced by the index of the first of these values, when the
+ *  values of a bucket follow each other, ordered by thread. 'firsts[b]' is set to the index of the
+ *  first value of the bucket 'b', and 'firsts[nbuckets]' to the total number of values.
+ */
+void parallel_prefix_sums(size_t * counts, size_t * firsts, unsigned int threads, size_t nbuckets);
+
+#endif
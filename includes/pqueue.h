@@ -27,7 +27,7 @@ typedef int (*t_cmpf)(void const * leftKey, void const * rightKey);
 typedef struct	s_pqueue_node {
 	void const	* key;
 	void const	* value;
-	unsigned int	index; /* index dans le tableau 'nodes' */
+	size_t		index; /* index dans le tableau 'nodes' */
 
 }		t_pqueue_node;
 
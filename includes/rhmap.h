@@ -0,0 +1,114 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef RHMAP_H
+# define RHMAP_H
+
+# include "common.h"
+
+/**
+ *  Robin Hood open addressing hash map, with the same API as 'hmap.h'
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - linear probing, where an inserted value takes the slot of any value closer to its
+ *        home slot than itself ("steal from the rich"). The probe lengths stay short and
+ *        close to each other, even at high load factor.
+ *      - a removal shifts the following values one slot backward, so there are no tombstones
+ *        and lookups dont slow down after many removals / insertions
+ *
+ *  example for a string hashmap:
+ *
+ *      t_rhmap * map = rhmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      rhmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      char *helloworld = rhmap_get(map, "ima key"); //now contains "Hello world"
+ */
+
+/** maximum load factor, in percent, before the table grows */
+# ifndef RHMAP_MAX_LOAD
+#   define RHMAP_MAX_LOAD 90
+# endif
+
+typedef struct  s_rhmap_slot {
+    unsigned long int hash; //hash of the key
+    void const * key; //the key used
+    void const * data; //the data holds
+    unsigned int psl; //probe sequence length + 1 (distance to the home slot), 0 if the slot is empty
+}               t_rhmap_slot;
+
+typedef struct  s_rhmap {
+    t_rhmap_slot * slots; //the slots
+    unsigned long int capacity; //number of slots (a power of two)
+    unsigned long int size; //number of value set
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where slot keys are sent as parameters
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_rhmap;
+
+/**
+ *  Create a new hashmap:
+ *
+ *  capacity : number of values the map should hold before growing
+ *  hashf    : hash function to use on inserted elements
+ *  cmpf     : comparison function to use when searching a data
+ */
+t_rhmap * rhmap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void rhmap_delete(t_rhmap * rhmap);
+
+/**
+ *  Insert a value into the hashmap:
+ *
+ *  return the given data if it was inserted properly, NULL elseway
+ */
+void const * rhmap_insert(t_rhmap * rhmap, void const * data, void const * key);
+
+/**
+ *  Get data from the hashmap, NULL if the key isnt found
+ */
+void * rhmap_get(t_rhmap * rhmap, void const * key);
+
+/**
+ *  Remove the data pointer from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int rhmap_remove_data(t_rhmap * rhmap, void const * data);
+
+/**
+ *  Remove the data which match with the given key from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int rhmap_remove_key(t_rhmap * rhmap, void const * key);
+
+/**
+ *  Macro to iterate fastly though to hash map
+ *
+ *  i.e:
+ *      RHMAP_ITER_START(rhmap, char *, str) {
+ *          puts(str);
+ *      }
+ *      RHMAP_ITER_END(rhmap, char *, str)
+ */
+# define RHMAP_ITER_START(H, T, V)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->capacity ; __i++) {\
+        if ((H)->slots[__i].psl != 0) {\
+            t_rhmap_slot * slot = (H)->slots + __i;\
+            T V = (T)(slot->data);
+# define RHMAP_ITER_END(H, T, V)\
+        }\
+    }\
+}
+
+#endif
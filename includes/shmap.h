@@ -0,0 +1,93 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef SHMAP_H
+# define SHMAP_H
+
+# include <pthread.h>
+# include "common.h"
+# include "hmap.h"
+
+/**
+ *  Thread safe hash map, with the same API as 'hmap.h' (link with -lpthread)
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - the keys are split between N shards, chosen with the high bits of the key hash
+ *        (the low bits are used by the shards to choose their lists)
+ *      - each shard is a 't_hmap' (with its own size and resize) protected by its own
+ *        reader-writer lock: lookups on a shard run concurrently, and operations on
+ *        different shards never wait for each other
+ *      - as for 'hmap.h', data and keys pointers are saved, and freed with 'datafreef' and 'keyfreef'.
+ *        'shmap_get()' returns the data once the lock is released: if another thread may remove
+ *        (and free) it meanwhile, the data lifetime should be handled by the caller
+ *
+ *  example for a string hashmap:
+ *
+ *      t_shmap * map = shmap_new(64, 1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      shmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      char *helloworld = shmap_get(map, "ima key"); //now contains "Hello world"
+ */
+
+typedef struct  s_shmap_shard {
+    pthread_rwlock_t lock; //lock of this shard
+    t_hmap * hmap; //values of this shard
+}               CACHE_ALIGNED t_shmap_shard;
+
+typedef struct  s_shmap {
+    t_shmap_shard * shards; //the shards
+    unsigned long int nshards; //number of shards (a power of two)
+    unsigned int shift; //shift applied on the mixed hash to get a shard index
+    t_hash_function hashf; //hash function
+}               t_shmap;
+
+/**
+ *  Create a new thread safe hashmap:
+ *
+ *  nshards  : number of shards, rounded to the next power of two (i.e: a few times the number of threads)
+ *  capacity : initial capacity of the hashmap (split between the shards)
+ *  hashf    : hash function to use on inserted elements
+ *  keycmpf  : comparison function to use when searching a data
+ *  keyfreef, datafreef : see 'hmap_new()'
+ */
+t_shmap * shmap_new(unsigned long int nshards, unsigned long int capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the hashmap from the heap (no other thread should use it anymore)
+ */
+void shmap_delete(t_shmap * shmap);
+
+/**
+ *  Insert a value into the hashmap
+ *  return the given data if it was inserted properly, NULL elseway
+ */
+void const * shmap_insert(t_shmap * shmap, void const * data, void const * key);
+
+/**
+ *  Get data from the hashmap, NULL if the key isnt found
+ */
+void * shmap_get(t_shmap * shmap, void const * key);
+
+/**
+ *  Remove the data pointer from the hash map (every shard is searched)
+ *  return 1 if the element was removed, 0 elseway
+ */
+int shmap_remove_data(t_shmap * shmap, void const * data);
+
+/**
+ *  Remove the data which match with the given key from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int shmap_remove_key(t_shmap * shmap, void const * key);
+
+/**
+ *  Number of values in the hashmap
+ */
+unsigned long int shmap_size(t_shmap * shmap);
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef SWMAP_H
+# define SWMAP_H
+
+# include "common.h"
+
+/**
+ *  Open addressing hash map, with the same API as 'hmap.h'
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - keys and values are stored in a flat array of slots: an insertion does no allocation
+ *        (except when the table grows)
+ *      - each slot has a control byte: empty, deleted, or 7 bits of the key hash.
+ *        The control bytes are scanned 16 at a time (one SSE2 comparison), and the key
+ *        comparison function is only called on slots whose 7 bits match.
+ *
+ *  example for a string hashmap:
+ *
+ *      t_swmap * map = swmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      swmap_insert(map, strdup("Hello world"), strdup("ima key"));
+ *      char *helloworld = swmap_get(map, "ima key"); //now contains "Hello world"
+ */
+
+/** number of control bytes scanned at once */
+# define SWMAP_GROUP 16
+
+/** control byte values (full slots holds 7 bits of the hash, between 0 and 127) */
+# define SWMAP_EMPTY   ((BYTE)0x80)
+# define SWMAP_DELETED ((BYTE)0xFE)
+
+typedef struct  s_swmap_slot {
+    void const * key; //the key used
+    void const * data; //the data holds
+}               t_swmap_slot;
+
+typedef struct  s_swmap {
+    BYTE * ctrl; //a control byte per slot
+    t_swmap_slot * slots; //the slots
+    unsigned long int capacity; //number of slots (a power of two, at least SWMAP_GROUP)
+    unsigned long int size; //number of value set
+    unsigned long int growth_left; //number of empty slots which can be used before the table is rehashed
+    t_hash_function hashf; //hash function
+    t_cmp_function keycmpf; //key comparison function, where slot keys are sent as parameters
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_swmap;
+
+/**
+ *  Create a new hashmap:
+ *
+ *  capacity : number of values the map should hold before growing
+ *  hashf    : hash function to use on inserted elements
+ *  cmpf     : comparison function to use when searching a data
+ */
+t_swmap * swmap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void swmap_delete(t_swmap * swmap);
+
+/**
+ *  Insert a value into the hashmap:
+ *
+ *  return the given data if it was inserted properly, NULL elseway
+ */
+void const * swmap_insert(t_swmap * swmap, void const * data, void const * key);
+
+/**
+ *  Get data from the hashmap, NULL if the key isnt found
+ */
+void * swmap_get(t_swmap * swmap, void const * key);
+
+/**
+ *  Remove the data pointer from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int swmap_remove_data(t_swmap * swmap, void const * data);
+
+/**
+ *  Remove the data which match with the given key from the hash map
+ *  return 1 if the element was removed, 0 elseway
+ */
+int swmap_remove_key(t_swmap * swmap, void const * key);
+
+/**
+ *  Macro to iterate fastly though to hash map
+ *
+ *  i.e:
+ *      SWMAP_ITER_START(swmap, char *, str) {
+ *          puts(str);
+ *      }
+ *      SWMAP_ITER_END(swmap, char *, str)
+ */
+# define SWMAP_ITER_START(H, T, V)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->capacity ; __i++) {\
+        if ((H)->ctrl[__i] < SWMAP_EMPTY) {\
+            t_swmap_slot * slot = (H)->slots + __i;\
+            T V = (T)(slot->data);
+# define SWMAP_ITER_END(H, T, V)\
+        }\
+    }\
+}
+
+#endif
@@ -0,0 +1,206 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef THMAP_H
+# define THMAP_H
+
+# include "common.h"
+
+/**
+ *  Typed hash maps: HMAP_DECLARE(name, K, V, hash, eq) generates a hash map from keys of type 'K'
+ *  to values of type 'V', specialised for these types:
+ *      - keys and values are stored by value in the map (no allocation per value, no pointer to follow)
+ *      - 'hash' and 'eq' are called directly, so the compiler can inline them
+ *
+ *  name : prefix of the generated type ('t_<name>') and functions ('<name>_new()', ...)
+ *  K    : type of the keys
+ *  V    : type of the values
+ *  hash : function (or macro) 'unsigned long int hash(K key)'
+ *  eq   : function (or macro) 'int eq(K a, K b)', returning non-zero if the keys are equal
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - open addressing with linear probing, in a power of two array of slots
+ *      - each slot holds the key hash (0 for an empty slot), compared before calling 'eq'
+ *      - removals shift the next slots back, so there are no tombstones
+ *      - the table doubles when it is 7/8 full
+ *
+ *  The generated functions are 'static inline': declare the map in the files which use it.
+ *
+ *  example, a map from integers to doubles:
+ *
+ *      # include "hash.h"
+ *
+ *      static inline unsigned long int int_hash(int k) { return (hash_u32((uint32_t)k)); }
+ *      # define INT_EQ(A, B) ((A) == (B))
+ *      HMAP_DECLARE(intmap, int, double, int_hash, INT_EQ)
+ *
+ *      t_intmap * map = intmap_new(1024);
+ *      intmap_insert(map, 42, 3.14);
+ *      double * value = intmap_get(map, 42); //now points to 3.14, NULL if 42 isnt in the map
+ *      intmap_remove(map, 42);
+ *      intmap_delete(map);
+ *
+ *  Generated functions:
+ *      t_<name> * <name>_new(unsigned long int capacity);
+ *      void       <name>_delete(t_<name> * map);
+ *      V *        <name>_insert(t_<name> * map, K key, V value); //insert, or replace the value of the key.
+ *                                                               //return the stored value, NULL if there is not enough memory
+ *      V *        <name>_get(t_<name> * map, K key); //NULL if the key isnt found
+ *      int        <name>_remove(t_<name> * map, K key); //1 if the key was removed, 0 elseway
+ *
+ *  The returned value pointers are valid until the next insertion or removal.
+ */
+
+/**
+ *  Macro to iterate though a typed map ('S' is a pointer to the current slot: 'S->key', 'S->value')
+ *
+ *  i.e:
+ *      HMAP_TYPED_ITER_START(intmap, map, slot) {
+ *          printf("%d -> %f\n", slot->key, slot->value);
+ *      }
+ *      HMAP_TYPED_ITER_END(intmap, map, slot)
+ */
+# define HMAP_TYPED_ITER_START(NAME, H, S)\
+{\
+    unsigned long int __i;\
+    for (__i = 0 ; __i < (H)->capacity ; __i++) {\
+        t_##NAME##_slot * S = (H)->slots + __i;\
+        if (S->hash != 0) {
+# define HMAP_TYPED_ITER_END(NAME, H, S)\
+        }\
+    }\
+}
+
+# define HMAP_DECLARE(NAME, K, V, HASH, EQ)\
+\
+typedef struct  s_##NAME##_slot {\
+    unsigned long int hash; /* hash of the key, 0 if the slot is empty */\
+    K key; /* the key */\
+    V value; /* the value */\
+}               t_##NAME##_slot;\
+\
+typedef struct  s_##NAME {\
+    t_##NAME##_slot * slots; /* the slots */\
+    unsigned long int capacity; /* number of slots (a power of two) */\
+    unsigned long int size; /* number of value set */\
+}               t_##NAME;\
+\
+/* internal function : hash of the key, never 0 (which marks the empty slots) */\
+static inline unsigned long int NAME##_hash(K key) {\
+    unsigned long int hash = HASH(key);\
+    return (hash == 0 ? 1 : hash);\
+}\
+\
+static inline t_##NAME * NAME##_new(unsigned long int capacity) {\
+    unsigned long int c = 8;\
+    while (c - c / 8 < capacity) {\
+        c = c << 1;\
+    }\
+    t_##NAME * map = (t_##NAME *)malloc(sizeof(t_##NAME));\
+    if (map == NULL) {\
+        return (NULL);\
+    }\
+    map->slots = (t_##NAME##_slot *)calloc(c, sizeof(t_##NAME##_slot));\
+    if (map->slots == NULL) {\
+        free(map);\
+        return (NULL);\
+    }\
+    map->capacity = c;\
+    map->size = 0;\
+    return (map);\
+}\
+\
+static inline void NAME##_delete(t_##NAME * map) {\
+    free(map->slots);\
+    free(map);\
+}\
+\
+/* internal function : index of the slot of the key, or of the empty slot where it should be */\
+static inline unsigned long int NAME##_find(t_##NAME * map, K key, unsigned long int hash) {\
+    unsigned long int mask = map->capacity - 1;\
+    unsigned long int i = hash & mask;\
+    while (map->slots[i].hash != 0) {\
+        if (map->slots[i].hash == hash && EQ(map->slots[i].key, key)) {\
+            return (i);\
+        }\
+        i = (i + 1) & mask;\
+    }\
+    return (i);\
+}\
+\
+/* internal function : move every value into a table of 'capacity' slots */\
+static inline int NAME##_rehash(t_##NAME * map, unsigned long int capacity) {\
+    t_##NAME##_slot * slots = (t_##NAME##_slot *)calloc(capacity, sizeof(t_##NAME##_slot));\
+    if (slots == NULL) {\
+        return (0);\
+    }\
+    unsigned long int i;\
+    for (i = 0 ; i < map->capacity ; i++) {\
+        if (map->slots[i].hash != 0) {\
+            unsigned long int j = map->slots[i].hash & (capacity - 1);\
+            while (slots[j].hash != 0) {\
+                j = (j + 1) & (capacity - 1);\
+            }\
+            slots[j] = map->slots[i];\
+        }\
+    }\
+    free(map->slots);\
+    map->slots = slots;\
+    map->capacity = capacity;\
+    return (1);\
+}\
+\
+static inline V * NAME##_insert(t_##NAME * map, K key, V value) {\
+    unsigned long int hash = NAME##_hash(key);\
+    unsigned long int i = NAME##_find(map, key, hash);\
+    if (map->slots[i].hash == 0) {\
+        if (map->size + 1 > map->capacity - map->capacity / 8) {\
+            if (!NAME##_rehash(map, map->capacity << 1)) {\
+                return (NULL);\
+            }\
+            i = NAME##_find(map, key, hash);\
+        }\
+        map->slots[i].hash = hash;\
+        map->slots[i].key = key;\
+        map->size++;\
+    }\
+    map->slots[i].value = value;\
+    return (&(map->slots[i].value));\
+}\
+\
+static inline V * NAME##_get(t_##NAME * map, K key) {\
+    unsigned long int i = NAME##_find(map, key, NAME##_hash(key));\
+    return (map->slots[i].hash == 0 ? NULL : &(map->slots[i].value));\
+}\
+\
+static inline int NAME##_remove(t_##NAME * map, K key) {\
+    unsigned long int mask = map->capacity - 1;\
+    unsigned long int i = NAME##_find(map, key, NAME##_hash(key));\
+    if (map->slots[i].hash == 0) {\
+        return (0);\
+    }\
+    /* shift back the next values which would be found before 'i' in their probe sequence */\
+    unsigned long int j = i;\
+    while (1) {\
+        j = (j + 1) & mask;\
+        if (map->slots[j].hash == 0) {\
+            break ;\
+        }\
+        unsigned long int k = map->slots[j].hash & mask;\
+        if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {\
+            map->slots[i] = map->slots[j];\
+            i = j;\
+        }\
+    }\
+    map->slots[i].hash = 0;\
+    map->size--;\
+    return (1);\
+}
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ *  This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *  It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *  This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *  PEREIRA Romain
+ */
+
+#ifndef TTLMAP_H
+# define TTLMAP_H
+
+# include <limits.h>
+# include "common.h"
+# include "hmap.h"
+# include "list.h"
+
+/**
+ *  Hash map which values expire after a time to live (TTL), given in milliseconds
+ *
+ *  ABOUT THE IMPLEMENTATION:
+ *      - given pointer address are saved for values and keys, no copy is done (as in 'hmap.h')
+ *      - a 't_hmap' finds the entries, and a hierarchical timer wheel orders them by expiry time:
+ *        TTLMAP_LEVELS wheels of TTLMAP_SLOTS lists. The first wheel has a list per millisecond,
+ *        the second a list per TTLMAP_SLOTS milliseconds, and so on. When the first wheel has
+ *        gone around, the next list of the second wheel is spread in the first one (and so on).
+ *        Each entry is moved at most TTLMAP_LEVELS times before it expires: O(1) per entry.
+ *      - the expired entries are removed a few at a time on each 'ttlmap_insert()', 'ttlmap_get()'
+ *        and 'ttlmap_remove_key()' call (at most TTLMAP_EXPIRE_STEP entries, even if more of them
+ *        expire in the same millisecond), so no call pays for a full scan
+ *      - an expired entry which wasnt removed yet is never returned
+ *      - the time is read from the monotonic clock
+ *
+ *  example for a session store:
+ *
+ *      t_ttlmap * sessions = ttlmap_new(1024, (t_hf)strhash, (t_cmpf)strcmp, free, free);
+ *      ttlmap_insert(sessions, strdup("user data"), strdup("session id"), 30 * 60 * 1000);
+ *      char * data = ttlmap_get(sessions, "session id"); //NULL after 30 minutes
+ */
+
+/** number of lists of a wheel (a power of two) */
+# ifndef TTLMAP_SLOTS_BITS
+#   define TTLMAP_SLOTS_BITS 6
+# endif
+# define TTLMAP_SLOTS (1 << TTLMAP_SLOTS_BITS)
+
+/** number of wheels: TTLs up to 2^(TTLMAP_SLOTS_BITS * TTLMAP_LEVELS) ms are placed directly (about 12 days) */
+# ifndef TTLMAP_LEVELS
+#   define TTLMAP_LEVELS 5
+# endif
+
+/** maximum number of entries expired or moved in the wheels on each operation */
+# ifndef TTLMAP_EXPIRE_STEP
+#   define TTLMAP_EXPIRE_STEP 32
+# endif
+
+typedef struct  s_ttlmap_entry {
+    void const * key; //the key used
+    void const * data; //the data holds
+    unsigned long int deadline; //time when the entry expires (in ms)
+    t_hmap_node * handle; //the node of the entry in the hash map
+    t_list * slot; //the wheel list which holds the entry
+}               t_ttlmap_entry;
+
+typedef struct  s_ttlmap {
+    t_hmap * hmap; //map of the keys to their entries
+    t_list wheels[TTLMAP_LEVELS][TTLMAP_SLOTS]; //the timer wheels
+    unsigned long int counts[TTLMAP_LEVELS]; //number of entries of each wheel
+    unsigned long int time; //time the wheels were advanced to (in ms)
+    int pending; //1 if the lists of the tick 'time' werent all spread or expired yet
+    struct timespec start; //the time 0 of the map
+    unsigned long int size; //number of value set (including the expired ones which werent removed yet)
+    t_function datafreef; //function call when a data object should be freed
+    t_function keyfreef; //function called when a key should be freed
+}               t_ttlmap;
+
+/**
+ *  Create a new TTL map:
+ *
+ *  capacity : initial capacity of the hash map
+ *  hashf    : hash function to use on keys
+ *  keycmpf  : comparison function to use when searching a data
+ */
+t_ttlmap * ttlmap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef);
+
+/**
+ *  Delete the map from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void ttlmap_delete(t_ttlmap * ttlmap);
+
+/**
+ *  Insert a value which expires in 'ttl' milliseconds ('ULONG_MAX' : it never expires).
+ *  If the key is already in the map, its data and key are replaced (the old ones are freed),
+ *  and its TTL is reset.
+ *
+ *  return the given data if it was inserted properly, NULL elseway
+ */
+void const * ttlmap_insert(t_ttlmap * ttlmap, void const * data, void const * key, unsigned long int ttl);
+
+/**
+ *  Get data from the map, NULL if the key isnt found or if its value expired
+ */
+void * ttlmap_get(t_ttlmap * ttlmap, void const * key);
+
+/**
+ *  Reset the TTL of the value of the key: it now expires in 'ttl' milliseconds ('ULONG_MAX' : never)
+ *  return 1 if the value was found, 0 elseway
+ */
+int ttlmap_touch(t_ttlmap * ttlmap, void const * key, unsigned long int ttl);
+
+/**
+ *  Remove the value of the key from the map (calling 'keyfreef' and 'datafreef')
+ *  return 1 if the element was removed, 0 elseway
+ */
+int ttlmap_remove_key(t_ttlmap * ttlmap, void const * key);
+
+/**
+ *  Remove every expired value now (the operations only remove a few of them each time)
+ */
+void ttlmap_expire(t_ttlmap * ttlmap);
+
+#endif
@@ -1,29 +1,53 @@
+# ifndef _GNU_SOURCE
+#	define _GNU_SOURCE /* mremap() */
+# endif
 # include "array.h"
+# ifdef __linux__
+#	include <sys/mman.h>
+#	include <unistd.h>
+# endif
 
 /**
  *	@require : la capacité de départ du tableau dynamique
  *	@ensure  : alloue en mémoire un tableau dynamique
  *	@assign  : ------------------
  */
-t_array * array_new(unsigned int defaultCapacity, unsigned int elemSize) {
+t_array * array_new(size_t defaultCapacity, size_t elemSize) {
 	t_array * array = (t_array *) malloc(sizeof(t_array));
 	if (array == NULL) {
 		/* pas assez de mémoire */
 		return (NULL);
 	}
-	size_t size = defaultCapacity * elemSize;
-	array->values = (BYTE *) malloc(size);
-	if (array->values == NULL) {
+	array->values = NULL;
+	array->capacity = 0;
+	array->size = 0;
+	array->elemSize = elemSize;
+	array->mapped = 0;
+	array->growth = ARRAY_GROWTH_HALF;
+	if (defaultCapacity > 0 && array_grow(array, defaultCapacity) == -1) {
 		/* pas assez de mémoire */
 		free(array);
 		return (NULL);
 	}
-	array->capacity = defaultCapacity;
-	array->size = 0;
-	array->elemSize = elemSize;
 	return (array);
 }
 
+/**
+ *	fonction interne : libère les valeurs du tableau
+ */
+static void array_free_values(t_array * array) {
+# ifdef __linux__
+	if (array->mapped) {
+		munmap(array->values, array->mapped);
+		array->mapped = 0;
+		array->values = NULL;
+		return ;
+	}
+# endif
+	free(array->values);
+	array->values = NULL;
+}
+
 /**
  *	@require : 'array': tableau dynamique alloué via 'array_new()'
  *	@ensure  : désalloue de la mémoire le tableau 'array()'
@@ -33,7 +57,7 @@ void array_delete(t_array * array) {
 	if (array == NULL) {
 		return ;
 	}
-	free(array->values);
+	array_free_values(array);
 	free(array);
 }
 
@@ -43,29 +67,80 @@ void array_delete(t_array * array) {
  *			ou NULL si erreur
  *	@assign  : -----------
  */
-void * array_get(t_array * array, unsigned int index) {
+void * array_get(t_array * array, size_t index) {
 	if (index >= array->size) {
 		return (NULL);
 	}
 	return (array->values + index * array->elemSize);
 }
 
+# ifdef __linux__
+/**
+ *	fonction interne : redimensionne les valeurs allouées via 'mmap()' à 'bytes' octets
+ *	(arrondi au nombre de pages), en les allouant ainsi si elles ne l'étaient pas.
+ *	renvoie -1 si erreur, 0 sinon
+ */
+static int array_remap(t_array * array, size_t bytes) {
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	if (bytes > (size_t)-1 - page) {
+		/* l'arrondi déborde */
+		return (-1);
+	}
+	bytes = (bytes + page - 1) / page * page;
+	void * values;
+	if (array->mapped) {
+		/* les pages sont déplacées, pas copiées */
+		values = mremap(array->values, array->mapped, bytes, MREMAP_MAYMOVE);
+		if (values == MAP_FAILED) {
+			return (-1);
+		}
+	} else {
+		values = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (values == MAP_FAILED) {
+			return (-1);
+		}
+		size_t used = array->size * array->elemSize;
+		if (used > 0) {
+			memcpy(values, array->values, used < bytes ? used : bytes);
+		}
+		free(array->values);
+	}
+	array->values = (BYTE *)values;
+	array->mapped = bytes;
+	/* la fin de la derniere page est utilisable */
+	array->capacity = bytes / array->elemSize;
+	return (0);
+}
+# endif
+
 /**
  *	@require : un tableau 'array' et une valeur 'value'
  *	@ensure  : modifie la capacité du tableau.
  *			renvoie -1 si erreur, 0 sinon
- *	@assign  : 'array->values' peut être modifié par 'realloc()'
+ *	@assign  : 'array->values' peut être modifié par 'realloc()' ou 'mremap()'
  */
-int array_grow(t_array * array, unsigned int capacity) {
+int array_grow(t_array * array, size_t capacity) {
 	if (capacity == 0) {
-		free(array->values);
-		array->values = NULL;
-	} else {
-		array->values = realloc(array->values, capacity * array->elemSize);
-		if (array->values == NULL) {
-			return (-1);
-		}
+		array_free_values(array);
+		array->capacity = 0;
+		return (0);
+	}
+	if (capacity > (size_t)-1 / array->elemSize) {
+		/* 'capacity * elemSize' déborde */
+		return (-1);
 	}
+	size_t bytes = capacity * array->elemSize;
+# ifdef __linux__
+	if (array->mapped || bytes >= ARRAY_MMAP_BYTES) {
+		return (array_remap(array, bytes));
+	}
+# endif
+	BYTE * values = (BYTE *) realloc(array->values, bytes);
+	if (values == NULL) {
+		/* l'ancien tableau reste valide */
+		return (-1);
+	}
+	array->values = values;
 	array->capacity = capacity;
 	return (0);
 }
@@ -76,35 +151,68 @@ int array_grow(t_array * array, unsigned int capacity) {
  *			renvoie -1 si erreur, 0 sinon
  *	@assign  : @see array_grow()
  */
-int array_ensure_capacity(t_array * array, unsigned int capacity) {
-	if (array->capacity > capacity) {
+int array_ensure_capacity(t_array * array, size_t capacity) {
+	if (array->capacity >= capacity) {
 		return (0);
 	}
-	unsigned int c = (capacity + 1) / 2 * 3;
+	size_t c = array->capacity < ARRAY_MIN_CAPACITY ? ARRAY_MIN_CAPACITY : array->capacity;
+	while (c < capacity) {
+		size_t step;
+		if (array->growth == ARRAY_GROWTH_DOUBLE) {
+			step = c;
+		} else if (array->growth == ARRAY_GROWTH_LINEAR) {
+			size_t linear = ARRAY_LINEAR_BYTES / array->elemSize;
+			if (linear == 0 || c < linear) {
+				step = c;
+			} else {
+				/* nombre de pas de 'linear' entrées pour atteindre 'capacity', en une fois */
+				size_t steps = (capacity - c - 1) / linear + 1;
+				step = steps > ((size_t)-1 - c) / linear ? (size_t)-1 : steps * linear;
+			}
+		} else {
+			step = c / 2;
+		}
+		if (step > (size_t)-1 - c) {
+			/* 'c + step' déborde: on s'arrête à la capacité demandée */
+			c = capacity;
+			break ;
+		}
+		c = c + step;
+	}
 	if (array_grow(array, c) == -1) {
-		return (-1);
+		/* la croissance a échoué, on essaye la capacité demandée exactement */
+		return (array_grow(array, capacity));
 	}
 	return (0);
 }
 
+/**
+ *	@require : un tableau 'array' et une politique de croissance
+ *	@ensure  : les prochaines croissances du tableau suivront la politique 'growth'
+ *	@assign  : array->growth
+ */
+void array_set_growth(t_array * array, t_array_growth growth) {
+	array->growth = growth;
+}
+
 /**
  *	@require : un tableau 'array', un index, et une valeur 'value'
  *	@ensure  : ajoutes la valeur 'value' a l'index donnée dans le tableau
  *			renvoie -1 en cas d'erreur, sinon l'index où l'élément a été inséré
  *	@assign  : grossit la capacité du tableau si necessaire
  */
-int array_set(t_array * array, unsigned int index, void * value) {
+ssize_t array_set(t_array * array, size_t index, void * value) {
 	if (index > array->size) {
 		index = array->size;
 	}
-	if (array_ensure_capacity(array, index) == -1) {
+	if (array_ensure_capacity(array, index + 1) == -1) {
 		return (-1);
 	}
 	memcpy(array->values + index * array->elemSize, value, array->elemSize);
 	if (index >= array->size) {
 		array->size = index + 1;
 	}
-	return (index);
+	return ((ssize_t)index);
 }
 
 /**
@@ -113,7 +221,7 @@ int array_set(t_array * array, unsigned int index, void * value) {
  *			renvoie -1 en cas d'erreur, sinon l'index du nouvel élément
  *	@assign  : modifie les valeurs du tableau
  */
-int array_add(t_array * array, void * value) {
+ssize_t array_add(t_array * array, void * value) {
 	return (array_set(array, array->size, value));
 }
 
@@ -123,16 +231,17 @@ int array_add(t_array * array, void * value) {
  *			return -1 si erreur, 0 sinon
  *	@assign  : modifie les valeurs du tableau
  */
-int array_addn(t_array * array, void * value, unsigned int n) {
-	if (array_ensure_capacity(array, array->size + n) == -1) {
+ssize_t array_addn(t_array * array, void * value, size_t n) {
+	/* 'array->size + n' ne doit pas déborder */
+	if (n > (size_t)-1 - array->size || array_ensure_capacity(array, array->size + n) == -1) {
 		return (-1);
 	}
-	unsigned int i;
+	size_t i;
 	for (i = 0 ; i < n ; i++) {
 		BYTE * addr = array->values + (array->size + i) * array->elemSize;
 		memcpy(addr, value, array->elemSize);
 	}
-	int idx = array->size;
+	ssize_t idx = (ssize_t)array->size;
 	array->size += n;
 	return (idx);
 }
@@ -143,11 +252,11 @@ int array_addn(t_array * array, void * value, unsigned int n) {
  *			return -1 si erreur, 0 sinon
  *	@assign  : modifie array->size
  */
-int array_addempty(t_array * array, unsigned int n) {
-	if (array_ensure_capacity(array, array->size + n) == -1) {
+ssize_t array_addempty(t_array * array, size_t n) {
+	if (n > (size_t)-1 - array->size || array_ensure_capacity(array, array->size + n) == -1) {
 		return (-1);
 	}
-	int idx = array->size;
+	ssize_t idx = (ssize_t)array->size;
 	array->size += n;
 	return (idx);
 }
@@ -159,15 +268,15 @@ int array_addempty(t_array * array, unsigned int n) {
  *			return -1 si erreur, l'index du 1er element inseré sinon
  *	@assign  : modifie les valeurs du tableau
  */
-int array_add_all(t_array * array, void * values, unsigned int count) {
-	if (array_ensure_capacity(array, array->size + count) == -1) {
+ssize_t array_add_all(t_array * array, void * values, size_t count) {
+	if (count > (size_t)-1 - array->size || array_ensure_capacity(array, array->size + count) == -1) {
 		/* pas assez de mémoire */
 		return (-1);
 	}
-	memcpy(array->values + array->size, values, count * array->elemSize);
-	unsigned int index = array->size;
+	memcpy(array->values + array->size * array->elemSize, values, count * array->elemSize);
+	size_t index = array->size;
 	array->size += count;
-	return ((int)index); 
+	return ((ssize_t)index);
 }
 
 /**
@@ -186,8 +295,7 @@ void array_clear(t_array * array) {
  *	@assign  : array->capacity peut être changé
  */
 void array_trim(t_array * array) {
-	array->capacity = array->size;
-	array->values = (BYTE *)realloc(array->values, array->size * array->elemSize);
+	array_grow(array, array->size);
 }
 
 /**
@@ -195,14 +303,14 @@ void array_trim(t_array * array) {
  *	@ensure  : supprime l'élément à l'index donné
  *	@assign  : les index des éléments suivant sont décalés pour éviter la fragmentation
  */
-void array_remove(t_array * array, unsigned int index) {
+void array_remove(t_array * array, size_t index) {
 	if (index >= array->size) {
 		return ;
 	}
 
-	unsigned int begin = index * array->elemSize;
-	unsigned int end = (array->size - 1) * array->elemSize;
-	unsigned int offset = end - begin;
+	size_t begin = index * array->elemSize;
+	size_t end = (array->size - 1) * array->elemSize;
+	size_t offset = end - begin;
 	if (offset != 0) {
 		BYTE * left = array->values + begin;
 		BYTE * right = array->values + begin + array->elemSize;
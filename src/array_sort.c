@@ -0,0 +1,271 @@
+# include "array.h"
+
+/**
+ *	Tris par base ("radix sort") des tableaux dynamiques d'entiers, de flottants,
+ *	ou de structures triées selon une clef entière.
+ *
+ *	Les valeurs sont triées octet par octet, de l'octet de poids faible à celui de poids fort
+ *	(tri LSD): chaque passe est un tri par dénombrement stable, sans aucune comparaison.
+ *	Les occurences de chaque octet sont comptées en une seule lecture du tableau, et les passes
+ *	où toutes les valeurs ont le même octet sont sautées (i.e, les petits entiers sur 64 bits).
+ */
+
+/** nombre de bits triés par passe */
+# define ARRAY_RADIX_BITS 8
+# define ARRAY_RADIX_SIZE (1 << ARRAY_RADIX_BITS)
+
+/** une clef, et l'index de sa valeur dans le tableau (@see array_sort_key()) */
+typedef struct	s_array_radix_pair {
+	uint64_t	key;
+	size_t		index;
+}		t_array_radix_pair;
+
+/**
+ *	fonction interne : génère le tri par base 'NAME' de 'n' valeurs de type 'T',
+ *	selon leur clef non signée de type 'K' ('KEY(value)').
+ *	'tmp' est un tampon de 'n' valeurs, le resultat est dans 'values'.
+ */
+# define ARRAY_RADIX_SORT(NAME, T, K, KEY)\
+static void NAME(T * values, T * tmp, size_t n) {\
+	size_t counts[sizeof(K)][ARRAY_RADIX_SIZE];\
+	size_t i;\
+	unsigned int d;\
+	memset(counts, 0, sizeof(counts));\
+	for (i = 0 ; i < n ; i++) {\
+		K key = KEY(values[i]);\
+		for (d = 0 ; d < sizeof(K) ; d++) {\
+			counts[d][(key >> (d * ARRAY_RADIX_BITS)) & (ARRAY_RADIX_SIZE - 1)]++;\
+		}\
+	}\
+	T * src = values;\
+	T * dst = tmp;\
+	for (d = 0 ; d < sizeof(K) ; d++) {\
+		unsigned int shift = d * ARRAY_RADIX_BITS;\
+		size_t * count = counts[d];\
+		/* toutes les valeurs ont le meme octet: la passe ne changerait rien */\
+		if (count[(KEY(src[0]) >> shift) & (ARRAY_RADIX_SIZE - 1)] == n) {\
+			continue ;\
+		}\
+		/* 'count[b]' devient l'index de la prochaine valeur d'octet 'b' */\
+		size_t index = 0;\
+		unsigned int b;\
+		for (b = 0 ; b < ARRAY_RADIX_SIZE ; b++) {\
+			size_t c = count[b];\
+			count[b] = index;\
+			index += c;\
+		}\
+		for (i = 0 ; i < n ; i++) {\
+			dst[count[(KEY(src[i]) >> shift) & (ARRAY_RADIX_SIZE - 1)]++] = src[i];\
+		}\
+		T * swap = src;\
+		src = dst;\
+		dst = swap;\
+	}\
+	if (src != values) {\
+		memcpy(values, src, n * sizeof(T));\
+	}\
+}
+
+# define ARRAY_RADIX_VALUE(X) (X)
+# define ARRAY_RADIX_PAIR_KEY(X) ((X).key)
+
+ARRAY_RADIX_SORT(array_radix_u32, uint32_t, uint32_t, ARRAY_RADIX_VALUE)
+ARRAY_RADIX_SORT(array_radix_u64, uint64_t, uint64_t, ARRAY_RADIX_VALUE)
+ARRAY_RADIX_SORT(array_radix_pairs, t_array_radix_pair, uint64_t, ARRAY_RADIX_PAIR_KEY)
+
+/**
+ *	fonction interne : trie les valeurs du tableau, entiers non signés de 'bits' bits
+ *	renvoie -1 si erreur, 0 sinon
+ */
+static int array_radix(t_array * array, size_t bits) {
+	if (array->elemSize != bits / 8) {
+		return (-1);
+	}
+	if (array->size < 2) {
+		return (0);
+	}
+	void * tmp = malloc(array->size * array->elemSize);
+	if (tmp == NULL) {
+		return (-1);
+	}
+	if (bits == 32) {
+		array_radix_u32((uint32_t *)array->values, (uint32_t *)tmp, array->size);
+	} else {
+		array_radix_u64((uint64_t *)array->values, (uint64_t *)tmp, array->size);
+	}
+	free(tmp);
+	return (0);
+}
+
+/**
+ *	fonctions internes : transforment les entiers signés et les flottants en entiers non signés
+ *	de même ordre (et inversement):
+ *		- le bit de signe des entiers signés est inversé
+ *		- les bits des flottants négatifs sont tous inversés, le bit de signe des positifs est inversé
+ */
+static void array_flip_i64(t_array * array) {
+	uint64_t * values = (uint64_t *)array->values;
+	size_t i;
+	for (i = 0 ; i < array->size ; i++) {
+		values[i] ^= (uint64_t)1 << 63;
+	}
+}
+
+static void array_flip_f64(t_array * array, int inverse) {
+	uint64_t * values = (uint64_t *)array->values;
+	size_t i;
+	for (i = 0 ; i < array->size ; i++) {
+		uint64_t negative = inverse ? !(values[i] >> 63) : values[i] >> 63;
+		values[i] ^= negative ? ~(uint64_t)0 : (uint64_t)1 << 63;
+	}
+}
+
+static void array_flip_f32(t_array * array, int inverse) {
+	uint32_t * values = (uint32_t *)array->values;
+	size_t i;
+	for (i = 0 ; i < array->size ; i++) {
+		uint32_t negative = inverse ? !(values[i] >> 31) : values[i] >> 31;
+		values[i] ^= negative ? ~(uint32_t)0 : (uint32_t)1 << 31;
+	}
+}
+
+/**
+ *	@require : un tableau 'array' d'éléments de type 'uint32_t' ('elemSize' doit être 4)
+ *	@ensure  : tri le tableau dans l'ordre croissant (tri par base)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_u32(t_array * array) {
+	return (array_radix(array, 32));
+}
+
+/**
+ *	@require : un tableau 'array' d'éléments de type 'uint64_t' ('elemSize' doit être 8)
+ *	@ensure  : tri le tableau dans l'ordre croissant (tri par base)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_u64(t_array * array) {
+	return (array_radix(array, 64));
+}
+
+/**
+ *	@require : un tableau 'array' d'éléments de type 'int64_t' ('elemSize' doit être 8)
+ *	@ensure  : tri le tableau dans l'ordre croissant (tri par base)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_i64(t_array * array) {
+	if (array->elemSize != sizeof(int64_t)) {
+		return (-1);
+	}
+	array_flip_i64(array);
+	int r = array_radix(array, 64);
+	array_flip_i64(array);
+	return (r);
+}
+
+/**
+ *	@require : un tableau 'array' d'éléments de type 'float' ('elemSize' doit être 4)
+ *	@ensure  : tri le tableau dans l'ordre croissant (tri par base).
+ *			-0.0 est placé avant 0.0, et les NaN aux extremités (selon leur signe)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_f32(t_array * array) {
+	if (array->elemSize != sizeof(float)) {
+		return (-1);
+	}
+	array_flip_f32(array, 0);
+	int r = array_radix(array, 32);
+	array_flip_f32(array, 1);
+	return (r);
+}
+
+/**
+ *	@require : un tableau 'array' d'éléments de type 'double' ('elemSize' doit être 8)
+ *	@ensure  : tri le tableau dans l'ordre croissant (tri par base).
+ *			-0.0 est placé avant 0.0, et les NaN aux extremités (selon leur signe)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_f64(t_array * array) {
+	if (array->elemSize != sizeof(double)) {
+		return (-1);
+	}
+	array_flip_f64(array, 0);
+	int r = array_radix(array, 64);
+	array_flip_f64(array, 1);
+	return (r);
+}
+
+/**
+ *	@require : un tableau 'array', et une fonction 'keyf' renvoyant la clef entière d'un élément
+ *	@ensure  : tri le tableau dans l'ordre croissant des clefs (tri par base, stable:
+ *			les éléments de même clef gardent leur ordre)
+ *			renvoie -1 si erreur, 0 sinon
+ *	@assign  : modifie les index des elements du tableau
+ */
+int array_sort_key(t_array * array, t_array_key_function keyf) {
+	size_t n = array->size;
+	if (n < 2) {
+		return (0);
+	}
+	/* les couples (clef, index) sont triés, puis les éléments sont déplacés une seule fois */
+	t_array_radix_pair * pairs = (t_array_radix_pair *)malloc(sizeof(t_array_radix_pair) * n * 2);
+	BYTE * sorted = (BYTE *)malloc(n * array->elemSize);
+	if (pairs == NULL || sorted == NULL) {
+		free(pairs);
+		free(sorted);
+		return (-1);
+	}
+	size_t i;
+	for (i = 0 ; i < n ; i++) {
+		pairs[i].key = keyf(array->values + i * array->elemSize);
+		pairs[i].index = i;
+	}
+	array_radix_pairs(pairs, pairs + n, n);
+	for (i = 0 ; i < n ; i++) {
+		memcpy(sorted + i * array->elemSize, array->values + pairs[i].index * array->elemSize, array->elemSize);
+	}
+	memcpy(array->values, sorted, n * array->elemSize);
+	free(pairs);
+	free(sorted);
+	return (0);
+}
+
+/*
+static int cmp_u64(void const * a, void const * b) {
+	uint64_t x = *(uint64_t const *)a;
+	uint64_t y = *(uint64_t const *)b;
+	return ((x > y) - (x < y));
+}
+
+int main() {
+	size_t n = 10000000;
+	t_array * a = array_new(n, sizeof(uint64_t));
+	t_array * b = array_new(n, sizeof(uint64_t));
+	size_t i;
+	uint64_t x = 88172645463325252ULL;
+	for (i = 0 ; i < n ; i++) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		array_add(a, &x);
+		array_add(b, &x);
+	}
+
+	clock_t t = clock();
+	array_sort(a, cmp_u64);
+	printf("array_sort     : %lf s\n", (double)(clock() - t) / CLOCKS_PER_SEC);
+
+	t = clock();
+	array_sort_u64(b);
+	printf("array_sort_u64 : %lf s\n", (double)(clock() - t) / CLOCKS_PER_SEC);
+
+	printf("same result : %s\n", memcmp(a->values, b->values, n * sizeof(uint64_t)) == 0 ? "yes" : "no");
+	array_delete(a);
+	array_delete(b);
+	return (0);
+}
+*/
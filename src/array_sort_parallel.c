@@ -0,0 +1,205 @@
+# include "array.h"
+# include "parallel.h"
+# include <unistd.h>
+
+/**
+ *	Tri parallèle d'un tableau dynamique ("sample sort"):
+ *
+ *		1. des échantillons du tableau sont triés, et 'k' séparateurs en sont choisis à intervalles
+ *		   réguliers: ils découpent les valeurs en '2k + 1' paquets de tailles proches.
+ *		   Les paquets impairs sont ceux des valeurs égales à un séparateur (ils n'ont pas à être triés,
+ *		   et une valeur très répétée ne surcharge pas un paquet)
+ *		2. chaque thread calcule le paquet des valeurs d'une partie du tableau (recherche dichotomique
+ *		   parmi les séparateurs), et compte les valeurs de chaque paquet
+ *		3. chaque thread copie ses valeurs dans leur paquet, dans un tableau temporaire
+ *		4. les threads trient les paquets (via 'qsort()') un à un, et les recopient dans le tableau
+ *
+ *	Les valeurs ne sont comparées qu'avec 'cmpf', quelque soit leur taille 'elemSize'.
+ */
+
+/** nombre de paquets par thread (plus il y en a, plus la charge des threads est équilibrée) */
+# ifndef ARRAY_SORT_BUCKETS_PER_THREAD
+#	define ARRAY_SORT_BUCKETS_PER_THREAD 4
+# endif
+
+/** nombre d'échantillons par séparateur */
+# ifndef ARRAY_SORT_OVERSAMPLING
+#	define ARRAY_SORT_OVERSAMPLING 32
+# endif
+
+/** nombre maximum de threads */
+# ifndef ARRAY_SORT_MAX_THREADS
+#	define ARRAY_SORT_MAX_THREADS 256
+# endif
+
+/** en dessous de ce nombre de valeurs, le tableau est trié par 'array_sort()' */
+# ifndef ARRAY_SORT_PARALLEL_MIN
+#	define ARRAY_SORT_PARALLEL_MIN 65536
+# endif
+
+typedef struct	s_array_psort {
+	t_array		* array;	/* le tableau trié */
+	int		(*cmpf)(const void * left, const void * right); /* fonction de comparaison */
+	unsigned int	threads;	/* nombre de threads */
+	BYTE		* splitters;	/* les séparateurs, triés */
+	size_t		nsplitters;	/* nombre de séparateurs */
+	size_t		nbuckets;	/* nombre de paquets (2 * nsplitters + 1) */
+	uint32_t	* buckets;	/* paquet de chaque valeur */
+	size_t		* counts;	/* 'counts[t * nbuckets + b]': valeurs du thread 't' dans le paquet 'b', puis index de la suivante */
+	size_t		* firsts;	/* index du premier élément de chaque paquet (et 'size' après le dernier) */
+	BYTE		* tmp;		/* les valeurs, rangées par paquet */
+	size_t		next_bucket;	/* prochain paquet à trier (pris par les threads au fur et à mesure) */
+}		t_array_psort;
+
+/** fonction interne : paquet de la valeur */
+static uint32_t array_psort_bucket(t_array_psort * sort, void const * value) {
+	size_t elemSize = sort->array->elemSize;
+	size_t lo = 0;
+	size_t hi = sort->nsplitters;
+	/* nombre de séparateurs strictement plus petits que la valeur */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (sort->cmpf(sort->splitters + mid * elemSize, value) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo < sort->nsplitters && sort->cmpf(sort->splitters + lo * elemSize, value) == 0) {
+		return ((uint32_t)(2 * lo + 1));
+	}
+	return ((uint32_t)(2 * lo));
+}
+
+/** fonction interne (phase 2) : calcule le paquet des valeurs du thread, et compte celles de chaque paquet */
+static void array_psort_classify(void * state, unsigned int thread) {
+	t_array_psort * sort = (t_array_psort *)state;
+	size_t * counts = sort->counts + thread * sort->nbuckets;
+	size_t to = parallel_from(sort->array->size, sort->threads, thread + 1);
+	size_t i;
+	for (i = parallel_from(sort->array->size, sort->threads, thread) ; i < to ; i++) {
+		uint32_t b = array_psort_bucket(sort, sort->array->values + i * sort->array->elemSize);
+		sort->buckets[i] = b;
+		counts[b]++;
+	}
+}
+
+/** fonction interne (phase 3) : copie les valeurs du thread dans leur paquet */
+static void array_psort_scatter(void * state, unsigned int thread) {
+	t_array_psort * sort = (t_array_psort *)state;
+	size_t * counts = sort->counts + thread * sort->nbuckets;
+	size_t elemSize = sort->array->elemSize;
+	size_t to = parallel_from(sort->array->size, sort->threads, thread + 1);
+	size_t i;
+	for (i = parallel_from(sort->array->size, sort->threads, thread) ; i < to ; i++) {
+		size_t index = counts[sort->buckets[i]]++;
+		memcpy(sort->tmp + index * elemSize, sort->array->values + i * elemSize, elemSize);
+	}
+}
+
+/** fonction interne (phase 4) : trie les paquets, et les recopie dans le tableau */
+static void array_psort_buckets(void * state, unsigned int thread) {
+	t_array_psort * sort = (t_array_psort *)state;
+	size_t elemSize = sort->array->elemSize;
+	size_t b;
+	(void)thread;
+	while ((b = __atomic_fetch_add(&(sort->next_bucket), 1, __ATOMIC_RELAXED)) < sort->nbuckets) {
+		size_t first = sort->firsts[b];
+		size_t count = sort->firsts[b + 1] - first;
+		/* les paquets impairs ne contiennent que des valeurs égales */
+		if (b % 2 == 0 && count > 1) {
+			qsort(sort->tmp + first * elemSize, count, elemSize, sort->cmpf);
+		}
+		memcpy(sort->array->values + first * elemSize, sort->tmp + first * elemSize, count * elemSize);
+	}
+}
+
+/**
+ *	fonction interne (phase 1) : choisit les séparateurs parmi des échantillons triés du tableau
+ *	renvoie -1 si erreur, 0 sinon
+ */
+static int array_psort_splitters(t_array_psort * sort) {
+	t_array * array = sort->array;
+	size_t elemSize = array->elemSize;
+	size_t nsamples = (sort->nsplitters + 1) * ARRAY_SORT_OVERSAMPLING;
+	BYTE * samples = (BYTE *)malloc(nsamples * elemSize);
+	if (samples == NULL) {
+		return (-1);
+	}
+	/* un échantillon pris au hasard dans chaque intervalle régulier du tableau */
+	size_t stride = array->size / nsamples;
+	uint64_t x = 88172645463325252ULL;
+	size_t i;
+	for (i = 0 ; i < nsamples ; i++) {
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		size_t index = i * stride + (size_t)(x % stride);
+		memcpy(samples + i * elemSize, array->values + index * elemSize, elemSize);
+	}
+	qsort(samples, nsamples, elemSize, sort->cmpf);
+	for (i = 0 ; i < sort->nsplitters ; i++) {
+		size_t index = (i + 1) * ARRAY_SORT_OVERSAMPLING;
+		memcpy(sort->splitters + i * elemSize, samples + index * elemSize, elemSize);
+	}
+	free(samples);
+	return (0);
+}
+
+/**
+ *	@require : un tableau 'array', une fonction de comparaison (voir strcmp()),
+ *			et un nombre de threads (0 pour le nombre de processeurs)
+ *	@ensure  : tri le tableau dans l'ordre croissant de la fonction de comparaison,
+ *			en parallèle ("sample sort")
+ *			renvoie -1 si erreur (le tableau n'est alors pas modifié), 0 sinon
+ *	@assign  : modifie les index des elements du tableau (en triant les elements)
+ */
+int array_sort_parallel(t_array * array, int (*cmpf)(const void * left, const void * right), unsigned int nthreads) {
+	if (nthreads == 0) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = cpus > 0 ? (unsigned int)cpus : 1;
+	}
+	if (nthreads > ARRAY_SORT_MAX_THREADS) {
+		nthreads = ARRAY_SORT_MAX_THREADS;
+	}
+	/* chaque intervalle d'échantillonnage doit contenir au moins une valeur */
+	while (nthreads > 1 && (size_t)nthreads * ARRAY_SORT_BUCKETS_PER_THREAD * ARRAY_SORT_OVERSAMPLING > array->size) {
+		nthreads /= 2;
+	}
+	if (nthreads == 1 || array->size < ARRAY_SORT_PARALLEL_MIN) {
+		array_sort(array, cmpf);
+		return (0);
+	}
+
+	t_array_psort sort;
+	size_t elemSize = array->elemSize;
+	sort.array = array;
+	sort.cmpf = cmpf;
+	sort.threads = nthreads;
+	sort.nsplitters = (size_t)nthreads * ARRAY_SORT_BUCKETS_PER_THREAD - 1;
+	sort.nbuckets = 2 * sort.nsplitters + 1;
+	sort.next_bucket = 0;
+	sort.splitters = (BYTE *)malloc(sort.nsplitters * elemSize);
+	sort.buckets = (uint32_t *)malloc(sizeof(uint32_t) * array->size);
+	sort.counts = (size_t *)calloc(sort.threads * sort.nbuckets, sizeof(size_t));
+	sort.firsts = (size_t *)malloc(sizeof(size_t) * (sort.nbuckets + 1));
+	sort.tmp = (BYTE *)malloc(array->size * elemSize);
+	int r = -1;
+	if (sort.splitters && sort.buckets && sort.counts && sort.firsts && sort.tmp
+			&& array_psort_splitters(&sort) == 0) {
+		parallel_run(&sort, sort.threads, array_psort_classify);
+
+		/* les valeurs d'un paquet se suivent, rangées par partie du tableau */
+		parallel_prefix_sums(sort.counts, sort.firsts, sort.threads, sort.nbuckets);
+
+		parallel_run(&sort, sort.threads, array_psort_scatter);
+		parallel_run(&sort, sort.threads, array_psort_buckets);
+		r = 0;
+	}
+	free(sort.splitters);
+	free(sort.buckets);
+	free(sort.counts);
+	free(sort.firsts);
+	free(sort.tmp);
+	return (r);
+}
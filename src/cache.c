@@ -0,0 +1,224 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "cache.h"
+
+/**
+ *	Create a new cache
+ */
+t_cache * cache_new(t_cache_policy policy, unsigned long int max_entries, unsigned long int max_bytes,
+                    t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef) {
+    t_cache * cache = (t_cache *)malloc(sizeof(t_cache));
+    if (cache == NULL) {
+        return (NULL);
+    }
+    //the map doesnt own the keys or the entries: the cache frees them
+    cache->hmap = hmap_new(max_entries ? max_entries : HMAP_MIN_CAPACITY, hashf, keycmpf, NULL, NULL);
+    if (cache->hmap == NULL) {
+        free(cache);
+        return (NULL);
+    }
+    if (!list_init(&(cache->entries))) {
+        hmap_delete(cache->hmap);
+        free(cache);
+        return (NULL);
+    }
+    cache->hand = cache->entries.head;
+    cache->policy = policy;
+    cache->max_entries = max_entries;
+    cache->max_bytes = max_bytes;
+    cache->bytes = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    cache->datafreef = datafreef;
+    cache->keyfreef = keyfreef;
+    return (cache);
+}
+
+/**
+ *	Delete the cache from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void cache_delete(t_cache * cache) {
+    CACHE_ITER_START(cache, void const *, data) {
+        if (cache->datafreef) {
+            cache->datafreef(data);
+        }
+        if (cache->keyfreef) {
+            cache->keyfreef(entry->key);
+        }
+    }
+    CACHE_ITER_END(cache, void const *, data)
+    list_clear(&(cache->entries));
+    free(cache->entries.head);
+    hmap_delete(cache->hmap);
+    free(cache);
+}
+
+/**
+ *	internal function : remove the entry from the map and the list, and free it
+ */
+static void cache_remove_entry(t_cache * cache, t_cache_entry * entry) {
+    t_list_node * node = (t_list_node *)entry - 1;
+    void const * data = entry->data;
+    void const * key = entry->key;
+
+    //the hand never stays on a removed entry
+    if (cache->hand == node) {
+        cache->hand = node->next;
+    }
+    hmap_remove_node(cache->hmap, entry->handle);
+    cache->bytes -= entry->size;
+    list_remove_node(&(cache->entries), node);
+
+    if (cache->datafreef) {
+        cache->datafreef(data);
+    }
+    if (cache->keyfreef) {
+        cache->keyfreef(key);
+    }
+}
+
+/**
+ *	internal function : return the next entry to evict, which is never 'keep'
+ *	(the entry which was just put: its data is returned to the caller)
+ */
+static t_cache_entry * cache_victim(t_cache * cache, t_cache_entry * keep) {
+    if (cache->policy == CACHE_LRU) {
+        t_cache_entry * entry = (t_cache_entry *)(cache->entries.head->next + 1);
+        if (entry == keep) {
+            entry = (t_cache_entry *)(cache->entries.head->next->next + 1);
+        }
+        return (entry);
+    }
+    //CACHE_CLOCK: give a second chance to the referenced entries.
+    //The hand goes around at most once before every flag is cleared, so this terminates
+    while (1) {
+        if (cache->hand == cache->entries.head) {
+            cache->hand = cache->hand->next;
+            continue ;
+        }
+        t_cache_entry * entry = (t_cache_entry *)(cache->hand + 1);
+        if (entry != keep) {
+            if (!entry->referenced) {
+                return (entry);
+            }
+            entry->referenced = 0;
+        }
+        cache->hand = cache->hand->next;
+    }
+}
+
+/**
+ *	internal function : evict entries (but 'keep') until the cache fits in its budget
+ */
+static void cache_evict(t_cache * cache, t_cache_entry * keep) {
+    //'keep' fits alone in the budget, so the loop ends before it is the last entry
+    while (cache->entries.size > 1
+            && ((cache->max_entries && cache->entries.size > cache->max_entries)
+                || (cache->max_bytes && cache->bytes > cache->max_bytes))) {
+        cache_remove_entry(cache, cache_victim(cache, keep));
+        cache->evictions++;
+    }
+}
+
+/**
+ *	internal function : mark the entry as recently used
+ */
+static void cache_touch(t_cache * cache, t_cache_entry * entry) {
+    if (cache->policy == CACHE_LRU) {
+        t_list_node * node = (t_list_node *)entry - 1;
+        list_unlink_node(&(cache->entries), node);
+        list_add_node(&(cache->entries), node);
+    } else {
+        __atomic_store_n(&(entry->referenced), 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ *	Get data from the cache, NULL if the key isnt found
+ */
+void * cache_get(t_cache * cache, void const * key) {
+    t_cache_entry * entry;
+    if (cache->policy == CACHE_CLOCK) {
+        //no list is migrated if the map is resizing: a CLOCK hit modifies nothing but the flag and the counters
+        entry = (t_cache_entry *)hmap_lookup_hashed(cache->hmap, key, cache->hmap->hashf(key));
+    } else {
+        entry = (t_cache_entry *)hmap_get(cache->hmap, key);
+    }
+    if (entry == NULL) {
+        __atomic_fetch_add(&(cache->misses), 1, __ATOMIC_RELAXED);
+        return (NULL);
+    }
+    __atomic_fetch_add(&(cache->hits), 1, __ATOMIC_RELAXED);
+    cache_touch(cache, entry);
+    return ((void *)entry->data);
+}
+
+/**
+ *	Insert a value into the cache, and evict entries until it fits in the budget
+ */
+void const * cache_put(t_cache * cache, void const * data, void const * key, unsigned long int size) {
+    if (cache->max_bytes && size > cache->max_bytes) {
+        return (NULL);
+    }
+
+    t_cache_entry * entry = (t_cache_entry *)hmap_get(cache->hmap, key);
+    if (entry != NULL) {
+        //replace the value of the key
+        void const * olddata = entry->data;
+        void const * oldkey = entry->key;
+        //the keys are equal: the map node can hold the new key
+        entry->handle->key = key;
+        entry->data = data;
+        entry->key = key;
+        cache->bytes = cache->bytes - entry->size + size;
+        entry->size = size;
+        cache_touch(cache, entry);
+        if (cache->datafreef && olddata != data) {
+            cache->datafreef(olddata);
+        }
+        if (cache->keyfreef && oldkey != key) {
+            cache->keyfreef(oldkey);
+        }
+    } else {
+        t_cache_entry buffer = {key, data, size, NULL, 0};
+        entry = (t_cache_entry *)list_add(&(cache->entries), &buffer, sizeof(t_cache_entry));
+        if (entry == NULL) {
+            return (NULL);
+        }
+        t_list_node * node = (t_list_node *)entry - 1;
+        entry->handle = hmap_insert_handle(cache->hmap, entry, key);
+        if (entry->handle == NULL) {
+            list_remove_node(&(cache->entries), node);
+            return (NULL);
+        }
+        //CACHE_CLOCK: the new entry is placed right behind the hand, so it is visited last
+        if (cache->policy == CACHE_CLOCK && cache->hand != cache->entries.head) {
+            list_unlink_node(&(cache->entries), node);
+            list_add_node_before(&(cache->entries), cache->hand, node);
+        }
+        cache->bytes += size;
+    }
+    cache_evict(cache, entry);
+    return (data);
+}
+
+/**
+ *	Remove the value of the key from the cache
+ *	return 1 if the element was removed, 0 elseway
+ */
+int cache_remove(t_cache * cache, void const * key) {
+    t_cache_entry * entry = (t_cache_entry *)hmap_get(cache->hmap, key);
+    if (entry == NULL) {
+        return (0);
+    }
+    cache_remove_entry(cache, entry);
+    return (1);
+}
@@ -0,0 +1,355 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "ckmap.h"
+#include "hash.h"
+
+/**
+ *	internal function : the tag of a hash. It is taken from the high bits of the mixed hash,
+ *	which are not used to choose the buckets
+ */
+static unsigned int ckmap_tag(unsigned long int hash) {
+    return ((unsigned int)(hash_u64(hash) >> 32));
+}
+
+/**
+ *	internal function : the other bucket of a value, from one of its buckets and its tag.
+ *	It only depends on the tag (and is never 'index' itself), so a kicked value is moved
+ *	without hashing its key again
+ */
+static unsigned long int ckmap_alt(t_ckmap * ckmap, unsigned long int index, unsigned int tag) {
+    return ((index ^ (hash_u64(tag) | 1)) & (ckmap->nbuckets - 1));
+}
+
+/** internal function : pseudo random number (xorshift), to choose the values to kick */
+static unsigned long int ckmap_random(t_ckmap * ckmap) {
+    ckmap->seed ^= ckmap->seed << 13;
+    ckmap->seed ^= ckmap->seed >> 7;
+    ckmap->seed ^= ckmap->seed << 17;
+    return (ckmap->seed);
+}
+
+/** internal function : allocate 'nbuckets' empty buckets, aligned on cache lines */
+static int ckmap_alloc(t_ckmap * ckmap, unsigned long int nbuckets) {
+    void * buckets;
+    if (posix_memalign(&buckets, CACHE_LINE, sizeof(t_ckmap_bucket) * nbuckets) != 0) {
+        return (0);
+    }
+    memset(buckets, 0, sizeof(t_ckmap_bucket) * nbuckets);
+    ckmap->buckets = (t_ckmap_bucket *)buckets;
+    ckmap->nbuckets = nbuckets;
+    return (1);
+}
+
+/**
+ *	internal function : set the value in an empty slot of the bucket
+ *	return 1 if it was set, 0 if the bucket is full
+ */
+static int ckmap_bucket_add(t_ckmap_bucket * bucket, t_ckmap_slot * item) {
+    int way;
+    for (way = 0 ; way < CKMAP_WAYS ; way++) {
+        if (bucket->keys[way] == NULL) {
+            bucket->keys[way] = item->key;
+            bucket->datas[way] = item->data;
+            bucket->tags[way] = item->tag;
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	internal function : place a value in one of its buckets ('index' is the first one), kicking
+ *	other values if needed, or in the stash. return 1 on success, 0 elseway (and the table is unchanged)
+ */
+static int ckmap_place(t_ckmap * ckmap, t_ckmap_slot const * value, unsigned long int index) {
+    t_ckmap_slot item = *value;
+    unsigned long int alt = ckmap_alt(ckmap, index, item.tag);
+    if (ckmap_bucket_add(ckmap->buckets + index, &item) || ckmap_bucket_add(ckmap->buckets + alt, &item)) {
+        return (1);
+    }
+
+    //both buckets are full: swap the value with a random one, and move this one to its other bucket
+    unsigned long int path[CKMAP_MAX_KICKS];
+    int ways[CKMAP_MAX_KICKS];
+    if (ckmap_random(ckmap) & 1) {
+        index = alt;
+    }
+    int kicks;
+    for (kicks = 0 ; kicks < CKMAP_MAX_KICKS ; kicks++) {
+        t_ckmap_bucket * bucket = ckmap->buckets + index;
+        int way = (int)(ckmap_random(ckmap) % CKMAP_WAYS);
+        t_ckmap_slot victim = {bucket->keys[way], bucket->datas[way], bucket->tags[way]};
+        bucket->keys[way] = item.key;
+        bucket->datas[way] = item.data;
+        bucket->tags[way] = item.tag;
+        item = victim;
+        path[kicks] = index;
+        ways[kicks] = way;
+
+        index = ckmap_alt(ckmap, index, item.tag);
+        if (ckmap_bucket_add(ckmap->buckets + index, &item)) {
+            return (1);
+        }
+    }
+
+    if (ckmap->stash_size < CKMAP_STASH_SIZE) {
+        ckmap->stash[ckmap->stash_size++] = item;
+        return (1);
+    }
+
+    //no place left: kick the values back to where they were
+    while (kicks > 0) {
+        --kicks;
+        t_ckmap_bucket * bucket = ckmap->buckets + path[kicks];
+        int way = ways[kicks];
+        t_ckmap_slot kicked = {bucket->keys[way], bucket->datas[way], bucket->tags[way]};
+        bucket->keys[way] = item.key;
+        bucket->datas[way] = item.data;
+        bucket->tags[way] = item.tag;
+        item = kicked;
+    }
+    return (0);
+}
+
+/**
+ *	internal function : place a value which first bucket isnt known (the table size changed),
+ *	by hashing its key again
+ */
+static int ckmap_place_key(t_ckmap * ckmap, t_ckmap_slot * item) {
+    unsigned long int hash = ckmap->hashf(item->key);
+    item->tag = ckmap_tag(hash);
+    return (ckmap_place(ckmap, item, hash & (ckmap->nbuckets - 1)));
+}
+
+/**
+ *	internal function : move every value (and 'extra', if not NULL) into a new table of at least
+ *	'nbuckets' buckets. The table doubles again while the values dont fit.
+ *	return 1 on success, 0 elseway (and the map is unchanged)
+ */
+static int ckmap_rehash(t_ckmap * ckmap, unsigned long int nbuckets, t_ckmap_slot const * extra) {
+    t_ckmap old = *ckmap;
+    while (1) {
+        if (!ckmap_alloc(ckmap, nbuckets)) {
+            *ckmap = old;
+            return (0);
+        }
+        ckmap->stash_size = 0;
+
+        int placed = 1;
+        unsigned long int i;
+        for (i = 0 ; placed && i < old.nbuckets * CKMAP_WAYS ; i++) {
+            t_ckmap_slot item = {old.buckets[i / CKMAP_WAYS].keys[i % CKMAP_WAYS],
+                                 old.buckets[i / CKMAP_WAYS].datas[i % CKMAP_WAYS], 0};
+            if (item.key != NULL) {
+                placed = ckmap_place_key(ckmap, &item);
+            }
+        }
+        for (i = 0 ; placed && i < old.stash_size ; i++) {
+            t_ckmap_slot item = old.stash[i];
+            placed = ckmap_place_key(ckmap, &item);
+        }
+        if (placed && extra != NULL) {
+            t_ckmap_slot item = *extra;
+            placed = ckmap_place_key(ckmap, &item);
+        }
+        if (placed) {
+            break ;
+        }
+        free(ckmap->buckets);
+        nbuckets = nbuckets << 1;
+    }
+    free(old.buckets);
+    return (1);
+}
+
+/**
+ *	Create a new hashmap:
+ *
+ *	capacity : number of values the map should hold before growing
+ *	hashf    : hash function to use on inserted elements
+ *	keycmpf  : comparison function to use when searching a data
+ */
+t_ckmap * ckmap_new(unsigned long int const capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+
+    // number of buckets : the closest power of two which holds 'capacity' values at 85% load
+    unsigned long int n = 2;
+    while (n * CKMAP_WAYS * 85 / 100 < capacity) {
+        n = n << 1;
+    }
+
+    t_ckmap * ckmap = (t_ckmap *)malloc(sizeof(t_ckmap));
+    if (ckmap == NULL) {
+        return (NULL);
+    }
+    if (!ckmap_alloc(ckmap, n)) {
+        free(ckmap);
+        return (NULL);
+    }
+
+    ckmap->stash_size = 0;
+    ckmap->size = 0;
+    ckmap->seed = 0x9E3779B97F4A7C15UL;
+    ckmap->hashf = hashf;
+    ckmap->keycmpf = keycmpf;
+    ckmap->datafreef = datafreef;
+    ckmap->keyfreef = keyfreef;
+
+    return (ckmap);
+}
+
+/**
+ *	Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void ckmap_delete(t_ckmap * ckmap) {
+    if (ckmap->datafreef || ckmap->keyfreef) {
+        CKMAP_ITER_START(ckmap, void const *, data) {
+            if (ckmap->datafreef) {
+                ckmap->datafreef(data);
+            }
+            if (ckmap->keyfreef) {
+                ckmap->keyfreef(slot->key);
+            }
+        }
+        CKMAP_ITER_END(ckmap, void const *, data)
+    }
+    free(ckmap->buckets);
+    free(ckmap);
+}
+
+/**
+ *	Insert a value into the hashmap:
+ *
+ *	return the given data if it was inserted properly, NULL elseway
+ */
+void const * ckmap_insert(t_ckmap * ckmap, void const * data, void const * key) {
+    unsigned long int hash = ckmap->hashf(key);
+    t_ckmap_slot item = {key, data, ckmap_tag(hash)};
+    if (!ckmap_place(ckmap, &item, hash & (ckmap->nbuckets - 1))
+            && !ckmap_rehash(ckmap, ckmap->nbuckets << 1, &item)) {
+        return (NULL);
+    }
+    ckmap->size++;
+    return (data);
+}
+
+/**
+ *	internal function : search the key. 'bucket' and 'way' are set to its slot in the buckets,
+ *	or 'bucket' is NULL and 'way' is its index in the stash.
+ *	return 1 if it was found, 0 elseway
+ */
+static int ckmap_find(t_ckmap * ckmap, void const * key, t_ckmap_bucket ** bucket, int * way) {
+    unsigned long int hash = ckmap->hashf(key);
+    unsigned long int index = hash & (ckmap->nbuckets - 1);
+    unsigned int tag = ckmap_tag(hash);
+    t_ckmap_bucket * b1 = ckmap->buckets + index;
+    t_ckmap_bucket * b2 = ckmap->buckets + ckmap_alt(ckmap, index, tag);
+    //both cache lines are loaded at once
+    PREFETCH(b2);
+
+    //the keys are only read if their tag matches
+    t_ckmap_bucket * buckets[2] = {b1, b2};
+    int b;
+    int w;
+    for (b = 0 ; b < 2 ; b++) {
+        for (w = 0 ; w < CKMAP_WAYS ; w++) {
+            if (buckets[b]->tags[w] == tag && buckets[b]->keys[w] != NULL
+                    && ckmap->keycmpf(key, buckets[b]->keys[w]) == 0) {
+                *bucket = buckets[b];
+                *way = w;
+                return (1);
+            }
+        }
+    }
+    for (w = 0 ; w < (int)ckmap->stash_size ; w++) {
+        if (ckmap->stash[w].tag == tag && ckmap->keycmpf(key, ckmap->stash[w].key) == 0) {
+            *bucket = NULL;
+            *way = w;
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	Get data from the hashmap, NULL if the key isnt found
+ */
+void * ckmap_get(t_ckmap * ckmap, void const * key) {
+    t_ckmap_bucket * bucket;
+    int way;
+    if (!ckmap_find(ckmap, key, &bucket, &way)) {
+        return (NULL);
+    }
+    return ((void *)(bucket ? bucket->datas[way] : ckmap->stash[way].data));
+}
+
+/**
+ *	internal function : remove the value of the slot, and free its data and key
+ */
+static void ckmap_remove_slot(t_ckmap * ckmap, t_ckmap_bucket * bucket, int way) {
+    void const * data;
+    void const * key;
+    if (bucket != NULL) {
+        data = bucket->datas[way];
+        key = bucket->keys[way];
+        bucket->keys[way] = NULL;
+        bucket->datas[way] = NULL;
+    } else {
+        data = ckmap->stash[way].data;
+        key = ckmap->stash[way].key;
+        ckmap->stash[way] = ckmap->stash[--ckmap->stash_size];
+    }
+    ckmap->size--;
+
+    if (ckmap->datafreef) {
+        ckmap->datafreef(data);
+    }
+    if (ckmap->keyfreef) {
+        ckmap->keyfreef(key);
+    }
+}
+
+/**
+ *	Remove the data pointer from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int ckmap_remove_data(t_ckmap * ckmap, void const * data) {
+    unsigned long int i;
+    for (i = 0 ; i < ckmap->nbuckets * CKMAP_WAYS ; i++) {
+        t_ckmap_bucket * bucket = ckmap->buckets + i / CKMAP_WAYS;
+        int way = (int)(i % CKMAP_WAYS);
+        if (bucket->keys[way] != NULL && bucket->datas[way] == data) {
+            ckmap_remove_slot(ckmap, bucket, way);
+            return (1);
+        }
+    }
+    for (i = 0 ; i < ckmap->stash_size ; i++) {
+        if (ckmap->stash[i].data == data) {
+            ckmap_remove_slot(ckmap, NULL, (int)i);
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	Remove the data which match with the given key from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int ckmap_remove_key(t_ckmap * ckmap, void const * key) {
+    t_ckmap_bucket * bucket;
+    int way;
+    if (!ckmap_find(ckmap, key, &bucket, &way)) {
+        return (0);
+    }
+    ckmap_remove_slot(ckmap, bucket, way);
+    return (1);
+}
@@ -0,0 +1,301 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "dhmap.h"
+
+/** internal values of the indices table : a free index, and the index of a removed entry */
+#define DHMAP_EMPTY (~0UL)
+#define DHMAP_DUMMY (~0UL - 1)
+
+/** internal function : number of entries a table of 'capacity' indices can index (2/3 of it) */
+static unsigned long int dhmap_usable(unsigned long int capacity) {
+    return (capacity - capacity / 3);
+}
+
+/** internal functions : read and write an index of the table, whatever its size */
+static unsigned long int dhmap_get_index(t_dhmap * dhmap, unsigned long int i) {
+    unsigned long int ix;
+    switch (dhmap->index_size) {
+        case 1:
+            ix = ((uint8_t *)dhmap->indices)[i];
+            return (ix >= 0xFE ? ~0UL - (0xFF - ix) : ix);
+        case 2:
+            ix = ((uint16_t *)dhmap->indices)[i];
+            return (ix >= 0xFFFE ? ~0UL - (0xFFFF - ix) : ix);
+        case 4:
+            ix = ((uint32_t *)dhmap->indices)[i];
+            return (ix >= 0xFFFFFFFE ? ~0UL - (0xFFFFFFFF - ix) : ix);
+        default:
+            return (((uint64_t *)dhmap->indices)[i]);
+    }
+}
+
+static void dhmap_set_index(t_dhmap * dhmap, unsigned long int i, unsigned long int ix) {
+    switch (dhmap->index_size) {
+        case 1:
+            ((uint8_t *)dhmap->indices)[i] = (uint8_t)ix;
+            break ;
+        case 2:
+            ((uint16_t *)dhmap->indices)[i] = (uint16_t)ix;
+            break ;
+        case 4:
+            ((uint32_t *)dhmap->indices)[i] = (uint32_t)ix;
+            break ;
+        default:
+            ((uint64_t *)dhmap->indices)[i] = (uint64_t)ix;
+            break ;
+    }
+}
+
+/**
+ *	internal function : return the position of the first free index in the probe sequence of 'hash'
+ */
+static unsigned long int dhmap_find_free(t_dhmap * dhmap, unsigned long int hash) {
+    unsigned long int mask = dhmap->capacity - 1;
+    unsigned long int perturb = hash;
+    unsigned long int i = hash & mask;
+    unsigned long int ix;
+    while ((ix = dhmap_get_index(dhmap, i)) != DHMAP_EMPTY && ix != DHMAP_DUMMY) {
+        //the high bits of the hash are mixed in little by little (as CPython does)
+        perturb >>= 5;
+        i = (i * 5 + perturb + 1) & mask;
+    }
+    return (i);
+}
+
+/**
+ *	internal function : move the entries to a new table of 'capacity' indices.
+ *	The holes left by removed entries are compacted, so insertion order is kept.
+ */
+static int dhmap_resize(t_dhmap * dhmap, unsigned long int capacity) {
+    //smallest index size which can hold every entry index, and the 2 special values
+    unsigned int index_size = 1;
+    while (index_size < 8 && dhmap_usable(capacity) >= (1UL << (index_size * 8)) - 2) {
+        index_size *= 2;
+    }
+    void * indices = malloc(capacity * index_size);
+    if (indices == NULL) {
+        return (0);
+    }
+    //the entries array only shrinks once compacted
+    unsigned long int usable = dhmap_usable(capacity);
+    int grows = (usable > dhmap->nentries);
+    if (grows) {
+        t_dhmap_entry * entries = (t_dhmap_entry *)realloc(dhmap->entries, sizeof(t_dhmap_entry) * usable);
+        if (entries == NULL) {
+            free(indices);
+            return (0);
+        }
+        dhmap->entries = entries;
+    }
+    //every byte to 0xFF : every index is DHMAP_EMPTY
+    memset(indices, 0xFF, capacity * index_size);
+    free(dhmap->indices);
+    dhmap->indices = indices;
+    dhmap->capacity = capacity;
+    dhmap->index_size = index_size;
+
+    unsigned long int n = 0;
+    unsigned long int i;
+    for (i = 0 ; i < dhmap->nentries ; i++) {
+        if (dhmap->entries[i].key != NULL) {
+            dhmap->entries[n] = dhmap->entries[i];
+            dhmap_set_index(dhmap, dhmap_find_free(dhmap, dhmap->entries[n].hash), n);
+            ++n;
+        }
+    }
+    dhmap->nentries = n;
+
+    if (!grows) {
+        //if shrinking fails, the bigger array is kept
+        t_dhmap_entry * entries = (t_dhmap_entry *)realloc(dhmap->entries, sizeof(t_dhmap_entry) * usable);
+        if (entries != NULL) {
+            dhmap->entries = entries;
+        }
+    }
+    return (1);
+}
+
+/**
+ *	Create a new hashmap:
+ *
+ *	capacity : number of values the map should hold before growing
+ *	hashf    : hash function to use on inserted elements
+ *	keycmpf  : comparison function to use when searching a data
+ */
+t_dhmap * dhmap_new(unsigned long int const capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+
+    // number of indices : the closest power of two which indexes 'capacity' entries
+    unsigned long int c = 8;
+    while (dhmap_usable(c) < capacity) {
+        c = c << 1;
+    }
+
+    t_dhmap * dhmap = (t_dhmap *)malloc(sizeof(t_dhmap));
+    if (dhmap == NULL) {
+        return (NULL);
+    }
+    dhmap->indices = NULL;
+    dhmap->entries = NULL;
+    dhmap->nentries = 0;
+    dhmap->size = 0;
+    if (!dhmap_resize(dhmap, c)) {
+        free(dhmap);
+        return (NULL);
+    }
+
+    dhmap->hashf = hashf;
+    dhmap->keycmpf = keycmpf;
+    dhmap->datafreef = datafreef;
+    dhmap->keyfreef = keyfreef;
+
+    return (dhmap);
+}
+
+/**
+ *	Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void dhmap_delete(t_dhmap * dhmap) {
+    if (dhmap->datafreef || dhmap->keyfreef) {
+        DHMAP_ITER_START(dhmap, void const *, data) {
+            if (dhmap->datafreef) {
+                dhmap->datafreef(data);
+            }
+            if (dhmap->keyfreef) {
+                dhmap->keyfreef(entry->key);
+            }
+        }
+        DHMAP_ITER_END(dhmap, void const *, data)
+    }
+    free(dhmap->indices);
+    free(dhmap->entries);
+    free(dhmap);
+}
+
+/**
+ *	Insert a value into the hashmap:
+ *
+ *	return the given data if it was inserted properly, NULL elseway
+ */
+void const * dhmap_insert(t_dhmap * dhmap, void const * data, void const * key) {
+    //no more room for an entry: resize for 3 times the number of values (as CPython does),
+    //which also compacts the entries
+    if (dhmap->nentries == dhmap_usable(dhmap->capacity)) {
+        unsigned long int c = 8;
+        while (c < dhmap->size * 3) {
+            c = c << 1;
+        }
+        if (!dhmap_resize(dhmap, c)) {
+            return (NULL);
+        }
+    }
+
+    unsigned long int hash = dhmap->hashf(key);
+    t_dhmap_entry * entry = dhmap->entries + dhmap->nentries;
+    entry->hash = hash;
+    entry->key = key;
+    entry->data = data;
+    dhmap_set_index(dhmap, dhmap_find_free(dhmap, hash), dhmap->nentries);
+    dhmap->nentries++;
+    dhmap->size++;
+    return (data);
+}
+
+/**
+ *	internal function : return the position in the indices table of the key, or -1 if it isnt found
+ */
+static long int dhmap_find(t_dhmap * dhmap, void const * key) {
+    unsigned long int hash = dhmap->hashf(key);
+    unsigned long int mask = dhmap->capacity - 1;
+    unsigned long int perturb = hash;
+    unsigned long int i = hash & mask;
+    unsigned long int ix;
+    while ((ix = dhmap_get_index(dhmap, i)) != DHMAP_EMPTY) {
+        if (ix != DHMAP_DUMMY) {
+            t_dhmap_entry * entry = dhmap->entries + ix;
+            if (entry->hash == hash && dhmap->keycmpf(key, entry->key) == 0) {
+                return ((long int)i);
+            }
+        }
+        perturb >>= 5;
+        i = (i * 5 + perturb + 1) & mask;
+    }
+    return (-1);
+}
+
+/**
+ *	Get data from the hashmap, NULL if the key isnt found
+ */
+void * dhmap_get(t_dhmap * dhmap, void const * key) {
+    long int i = dhmap_find(dhmap, key);
+    if (i < 0) {
+        return (NULL);
+    }
+    return ((void *)dhmap->entries[dhmap_get_index(dhmap, (unsigned long int)i)].data);
+}
+
+/**
+ *	internal function : remove the entry indexed at the given position, and free its data and key
+ */
+static void dhmap_remove_index(t_dhmap * dhmap, unsigned long int i) {
+    t_dhmap_entry * entry = dhmap->entries + dhmap_get_index(dhmap, i);
+    void const * data = entry->data;
+    void const * key = entry->key;
+
+    //the index stays used, so the probe sequences going through it arent broken
+    dhmap_set_index(dhmap, i, DHMAP_DUMMY);
+    entry->key = NULL;
+    entry->data = NULL;
+    dhmap->size--;
+
+    if (dhmap->datafreef) {
+        dhmap->datafreef(data);
+    }
+    if (dhmap->keyfreef) {
+        dhmap->keyfreef(key);
+    }
+}
+
+/**
+ *	Remove the data pointer from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int dhmap_remove_data(t_dhmap * dhmap, void const * data) {
+    DHMAP_ITER_START(dhmap, void const *, value) {
+        if (value == data) {
+            //many values may have the same key: follow the probe sequence up to this entry
+            unsigned long int mask = dhmap->capacity - 1;
+            unsigned long int perturb = entry->hash;
+            unsigned long int j = entry->hash & mask;
+            while (dhmap_get_index(dhmap, j) != __i) {
+                perturb >>= 5;
+                j = (j * 5 + perturb + 1) & mask;
+            }
+            dhmap_remove_index(dhmap, j);
+            return (1);
+        }
+    }
+    DHMAP_ITER_END(dhmap, void const *, value)
+    return (0);
+}
+
+/**
+ *	Remove the data which match with the given key from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int dhmap_remove_key(t_dhmap * dhmap, void const * key) {
+    long int i = dhmap_find(dhmap, key);
+    if (i < 0) {
+        return (0);
+    }
+    dhmap_remove_index(dhmap, (unsigned long int)i);
+    return (1);
+}
@@ -0,0 +1,314 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "fhmap.h"
+#include "bitmap.h"
+
+/** internal structure : a value of the map being frozen */
+typedef struct  s_fhmap_entry {
+    unsigned long int hash; //hash of the key
+    void const * key; //the key used
+    void const * data; //the data holds
+    unsigned long int slot; //position, then slot of the value, or index of the kept entry if this one is a duplicate
+    int keep; //0 if the key is a duplicate, and this value is dropped
+}               t_fhmap_entry;
+
+/** internal function : bucket of a hash */
+static unsigned long int fhmap_bucket(unsigned long int hash, unsigned long int nbuckets) {
+    return (hash % nbuckets);
+}
+
+/** internal function : position of a hash in the table, for the given bucket seed */
+static unsigned long int fhmap_position(unsigned long int hash, uint32_t seed, unsigned long int npositions) {
+    return (hash_u64(hash ^ ((uint64_t)seed * 0x9E3779B97F4A7C15ULL)) % npositions);
+}
+
+/** internal function : entries comparison on their hash */
+static int fhmap_entry_cmp(void const * a, void const * b) {
+    unsigned long int ha = ((t_fhmap_entry const *)a)->hash;
+    unsigned long int hb = ((t_fhmap_entry const *)b)->hash;
+    return ((ha > hb) - (ha < hb));
+}
+
+/**
+ *	internal function : mark the duplicated keys (the entries are sorted by hash).
+ *	For each key, the value kept is the one 'hmap_get()' returns.
+ *	return the number of entries kept, or 0 if two different keys have the same hash
+ */
+static unsigned long int fhmap_mark_duplicates(t_hmap * hmap, t_fhmap_entry * entries, unsigned long int n) {
+    unsigned long int kept = 0;
+    unsigned long int i = 0;
+    while (i < n) {
+        unsigned long int j = i + 1;
+        while (j < n && entries[j].hash == entries[i].hash) {
+            if (hmap->keycmpf(entries[i].key, entries[j].key) != 0) {
+                return (0);
+            }
+            ++j;
+        }
+        if (j - i == 1) {
+            entries[i].keep = 1;
+        } else {
+            void const * data = hmap_lookup_hashed(hmap, entries[i].key, entries[i].hash);
+            unsigned long int k = i;
+            while (k < j - 1 && entries[k].data != data) {
+                ++k;
+            }
+            unsigned long int l;
+            for (l = i ; l < j ; l++) {
+                entries[l].keep = (l == k);
+                entries[l].slot = k;
+            }
+        }
+        ++kept;
+        i = j;
+    }
+    return (kept);
+}
+
+/**
+ *	internal function : compress the table: the positions after the last slot are remapped
+ *	to the free slots, in order. Set the slot of every kept entry.
+ */
+static void fhmap_compress(t_fhmap * fhmap, t_fhmap_entry * entries, unsigned long int n, t_bitmap * taken) {
+    unsigned long int free_slot = 0;
+    unsigned long int p;
+    for (p = fhmap->size ; p < fhmap->npositions ; p++) {
+        if (bitmap_get(taken, p)) {
+            //there are as many free slots before 'size' as taken positions after it
+            while (bitmap_get(taken, free_slot)) {
+                ++free_slot;
+            }
+            fhmap->remap[p - fhmap->size] = free_slot++;
+        } else {
+            fhmap->remap[p - fhmap->size] = 0;
+        }
+    }
+    unsigned long int i;
+    for (i = 0 ; i < n ; i++) {
+        if (entries[i].keep && entries[i].slot >= fhmap->size) {
+            entries[i].slot = fhmap->remap[entries[i].slot - fhmap->size];
+        }
+    }
+}
+
+/**
+ *	internal function : search a seed for every bucket, and set the slot of every kept entry.
+ *	The biggest buckets are placed first, while most of the positions are free.
+ *	return 1 on success, 0 elseway
+ */
+static int fhmap_build(t_fhmap * fhmap, t_fhmap_entry * entries, unsigned long int n) {
+    unsigned long int * first = (unsigned long int *)calloc(fhmap->nbuckets + 1, sizeof(unsigned long int));
+    unsigned long int * hashes = (unsigned long int *)malloc(sizeof(unsigned long int) * (fhmap->size + 1));
+    unsigned long int * positions = (unsigned long int *)malloc(sizeof(unsigned long int) * (fhmap->size + 1));
+    t_bitmap * taken = bitmap_new(fhmap->npositions);
+    int success = 0;
+    if (first == NULL || hashes == NULL || positions == NULL || taken == NULL) {
+        goto end;
+    }
+    bitmap_zeroes(taken);
+
+    //group the hashes by bucket ('first[b]' is the first hash of the bucket 'b' in 'hashes'):
+    //the seed search then reads them contiguously
+    unsigned long int i;
+    unsigned long int maxsize = 0;
+    for (i = 0 ; i < n ; i++) {
+        if (entries[i].keep) {
+            first[fhmap_bucket(entries[i].hash, fhmap->nbuckets) + 1]++;
+        }
+    }
+    unsigned long int b;
+    for (b = 0 ; b < fhmap->nbuckets ; b++) {
+        if (first[b + 1] > maxsize) {
+            maxsize = first[b + 1];
+        }
+        first[b + 1] += first[b];
+    }
+    for (i = 0 ; i < n ; i++) {
+        if (entries[i].keep) {
+            b = fhmap_bucket(entries[i].hash, fhmap->nbuckets);
+            hashes[first[b]++] = entries[i].hash;
+        }
+    }
+    //'first[b]' is now the end of the bucket 'b': shift it back
+    for (b = fhmap->nbuckets ; b > 0 ; b--) {
+        first[b] = first[b - 1];
+    }
+    first[0] = 0;
+
+    unsigned long int size;
+    for (size = maxsize ; size > 0 ; size--) {
+        for (b = 0 ; b < fhmap->nbuckets ; b++) {
+            if (first[b + 1] - first[b] != size) {
+                continue ;
+            }
+            unsigned long int * bucket = hashes + first[b];
+            unsigned long int * position = positions + first[b];
+            uint32_t seed;
+            for (seed = 0 ; seed < FHMAP_MAX_SEED ; seed++) {
+                unsigned long int k;
+                for (k = 0 ; k < size ; k++) {
+                    position[k] = fhmap_position(bucket[k], seed, fhmap->npositions);
+                    if (bitmap_get(taken, position[k])) {
+                        break ;
+                    }
+                    bitmap_set(taken, position[k]);
+                }
+                if (k == size) {
+                    break ;
+                }
+                //a slot is already taken: free the ones of this try
+                while (k > 0) {
+                    --k;
+                    bitmap_unset(taken, position[k]);
+                }
+            }
+            if (seed == FHMAP_MAX_SEED) {
+                goto end;
+            }
+            fhmap->seeds[b] = seed;
+        }
+    }
+    for (i = 0 ; i < n ; i++) {
+        if (entries[i].keep) {
+            uint32_t seed = fhmap->seeds[fhmap_bucket(entries[i].hash, fhmap->nbuckets)];
+            entries[i].slot = fhmap_position(entries[i].hash, seed, fhmap->npositions);
+        }
+    }
+    fhmap_compress(fhmap, entries, n, taken);
+    success = 1;
+
+end:
+    free(first);
+    free(hashes);
+    free(positions);
+    if (taken) {
+        bitmap_delete(taken);
+    }
+    return (success);
+}
+
+/**
+ *	Freeze the hash map: build an immutable frozen map with its values, and delete 'hmap'
+ */
+t_fhmap * hmap_freeze(t_hmap * hmap) {
+    unsigned long int n = hmap->size;
+    t_fhmap_entry * entries = (t_fhmap_entry *)malloc(sizeof(t_fhmap_entry) * (n + 1));
+    if (entries == NULL) {
+        return (NULL);
+    }
+    //('i' is declared by HMAP_ITER_START)
+    t_fhmap_entry * entry = entries;
+    HMAP_ITER_START(hmap, void const *, data) {
+        entry->hash = node->hash;
+        entry->key = node->key;
+        entry->data = data;
+        ++entry;
+    }
+    HMAP_ITER_END(hmap, void const *, data)
+    qsort(entries, n, sizeof(t_fhmap_entry), fhmap_entry_cmp);
+
+    unsigned long int size = fhmap_mark_duplicates(hmap, entries, n);
+    if (n > 0 && size == 0) {
+        free(entries);
+        return (NULL);
+    }
+
+    t_fhmap * fhmap = (t_fhmap *)malloc(sizeof(t_fhmap));
+    if (fhmap == NULL) {
+        free(entries);
+        return (NULL);
+    }
+    fhmap->size = size;
+    fhmap->nbuckets = size / FHMAP_BUCKET_SIZE + 1;
+    fhmap->npositions = size / FHMAP_LOAD * 100 + size % FHMAP_LOAD * 100 / FHMAP_LOAD + 1;
+    fhmap->seeds = (uint32_t *)calloc(fhmap->nbuckets, sizeof(uint32_t));
+    fhmap->slots = (t_fhmap_slot *)malloc(sizeof(t_fhmap_slot) * (size + 1));
+    fhmap->remap = (unsigned long int *)malloc(sizeof(unsigned long int) * (fhmap->npositions - size));
+    if (fhmap->seeds == NULL || fhmap->slots == NULL || fhmap->remap == NULL || !fhmap_build(fhmap, entries, n)) {
+        free(fhmap->seeds);
+        free(fhmap->slots);
+        free(fhmap->remap);
+        free(fhmap);
+        free(entries);
+        return (NULL);
+    }
+    fhmap->hashf = hmap->hashf;
+    fhmap->keycmpf = hmap->keycmpf;
+    fhmap->datafreef = hmap->datafreef;
+    fhmap->keyfreef = hmap->keyfreef;
+
+    unsigned long int i;
+    for (i = 0 ; i < n ; i++) {
+        if (entries[i].keep) {
+            fhmap->slots[entries[i].slot].key = entries[i].key;
+            fhmap->slots[entries[i].slot].data = entries[i].data;
+        }
+    }
+    //free the duplicated values (unless they share their pointers with the kept value)
+    for (i = 0 ; i < n ; i++) {
+        t_fhmap_entry * kept = entries + entries[i].slot;
+        if (!entries[i].keep) {
+            if (fhmap->datafreef && entries[i].data != kept->data) {
+                fhmap->datafreef(entries[i].data);
+            }
+            if (fhmap->keyfreef && entries[i].key != kept->key) {
+                fhmap->keyfreef(entries[i].key);
+            }
+        }
+    }
+    free(entries);
+
+    //the keys and data now belong to the frozen map
+    hmap->datafreef = NULL;
+    hmap->keyfreef = NULL;
+    hmap_delete(hmap);
+    return (fhmap);
+}
+
+/**
+ *	Delete the frozen map from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void fhmap_delete(t_fhmap * fhmap) {
+    if (fhmap->datafreef || fhmap->keyfreef) {
+        FHMAP_ITER_START(fhmap, void const *, data) {
+            if (fhmap->datafreef) {
+                fhmap->datafreef(data);
+            }
+            if (fhmap->keyfreef) {
+                fhmap->keyfreef(slot->key);
+            }
+        }
+        FHMAP_ITER_END(fhmap, void const *, data)
+    }
+    free(fhmap->seeds);
+    free(fhmap->slots);
+    free(fhmap->remap);
+    free(fhmap);
+}
+
+/**
+ *	Get data from the frozen map, NULL if the key isnt found
+ */
+void * fhmap_get(t_fhmap * fhmap, void const * key) {
+    if (fhmap->size == 0) {
+        return (NULL);
+    }
+    unsigned long int hash = fhmap->hashf(key);
+    uint32_t seed = fhmap->seeds[fhmap_bucket(hash, fhmap->nbuckets)];
+    unsigned long int position = fhmap_position(hash, seed, fhmap->npositions);
+    if (position >= fhmap->size) {
+        position = fhmap->remap[position - fhmap->size];
+    }
+    t_fhmap_slot * slot = fhmap->slots + position;
+    if (fhmap->keycmpf(key, slot->key) != 0) {
+        return (NULL);
+    }
+    return ((void *)slot->data);
+}
@@ -0,0 +1,260 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "hash.h"
+
+/** internal constants : default secret of wyhash */
+static uint64_t const hash_secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+/** internal function : 64 x 64 bits multiplication, low bits in '*a' and high bits in '*b' */
+static void hash_mum(uint64_t * a, uint64_t * b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/** internal function : multiply and fold */
+static uint64_t hash_mix(uint64_t a, uint64_t b) {
+    hash_mum(&a, &b);
+    return (a ^ b);
+}
+
+/** internal functions : unaligned little endian reads */
+static uint64_t hash_r8(BYTE const * p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return (v);
+}
+
+static uint64_t hash_r4(BYTE const * p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return (v);
+}
+
+static uint64_t hash_r3(BYTE const * p, unsigned long int k) {
+    return (((uint64_t)p[0]) << 16 | ((uint64_t)p[k >> 1]) << 8 | p[k - 1]);
+}
+
+/**
+ *	Hash 'size' bytes, reading them 8 by 8 (wyhash algorithm)
+ */
+unsigned long int hash_bytes(void const * data, unsigned long int size, unsigned long int seed) {
+    BYTE const * p = (BYTE const *)data;
+    uint64_t s = (uint64_t)seed ^ hash_mix((uint64_t)seed ^ hash_secret[0], hash_secret[1]);
+    uint64_t a;
+    uint64_t b;
+
+    if (size <= 16) {
+        if (size >= 4) {
+            a = (hash_r4(p) << 32) | hash_r4(p + ((size >> 3) << 2));
+            b = (hash_r4(p + size - 4) << 32) | hash_r4(p + size - 4 - ((size >> 3) << 2));
+        } else if (size > 0) {
+            a = hash_r3(p, size);
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        unsigned long int i = size;
+        //3 independent lanes of 16 bytes, so the multiplications run in parallel
+        if (i > 48) {
+            uint64_t s1 = s;
+            uint64_t s2 = s;
+            do {
+                s = hash_mix(hash_r8(p) ^ hash_secret[1], hash_r8(p + 8) ^ s);
+                s1 = hash_mix(hash_r8(p + 16) ^ hash_secret[2], hash_r8(p + 24) ^ s1);
+                s2 = hash_mix(hash_r8(p + 32) ^ hash_secret[3], hash_r8(p + 40) ^ s2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            s ^= s1 ^ s2;
+        }
+        while (i > 16) {
+            s = hash_mix(hash_r8(p) ^ hash_secret[1], hash_r8(p + 8) ^ s);
+            i -= 16;
+            p += 16;
+        }
+        a = hash_r8(p + i - 16);
+        b = hash_r8(p + i - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= s;
+    hash_mum(&a, &b);
+    return ((unsigned long int)hash_mix(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]));
+}
+
+/**
+ *	Hash a string
+ */
+unsigned long int strhash_seeded(char const * str, unsigned long int seed) {
+    return (hash_bytes(str, strlen(str), seed));
+}
+
+/**
+ *	Mix the bits of a 32 bits integer (murmur3 finalizer)
+ */
+unsigned long int hash_u32(uint32_t value) {
+    uint64_t h = value;
+    //64 bits finalizer, so the high bits of the hash are mixed too
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return ((unsigned long int)h);
+}
+
+/**
+ *	Mix the bits of a 64 bits integer (splitmix64 finalizer)
+ */
+unsigned long int hash_u64(uint64_t value) {
+    uint64_t h = value;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return ((unsigned long int)h);
+}
+
+/**
+ *	Hash functions for keys pointing to integers, and for pointers keys
+ */
+unsigned long int u32hash(uint32_t const * key) {
+    return (hash_u32(*key));
+}
+
+unsigned long int u64hash(uint64_t const * key) {
+    return (hash_u64(*key));
+}
+
+unsigned long int ptrhash(void const * ptr) {
+    return (hash_u64((uint64_t)(uintptr_t)ptr));
+}
+
+/**
+ *	Comparison functions for keys pointing to integers, and for pointers keys
+ */
+int u32cmp(uint32_t const * a, uint32_t const * b) {
+    return ((*a > *b) - (*a < *b));
+}
+
+int u64cmp(uint64_t const * a, uint64_t const * b) {
+    return ((*a > *b) - (*a < *b));
+}
+
+int ptrcmp(void const * a, void const * b) {
+    return ((a > b) - (a < b));
+}
+
+/*
+//hash functions benchmark: throughput, and distribution of the keys in 2^16 buckets
+//cc -O3 hash.c bench.c -I ../includes
+
+#define BUCKETS (1 << 16)
+#define KEYS    (1 << 22)
+
+static unsigned long int djb2(char const * str) {
+    unsigned long int hash = 5381;
+    int c;
+    while ((c = *str++) != '\0') {
+        hash = ((hash << 5) + hash) + c;
+    }
+    return (hash);
+}
+
+static unsigned long int wyhash(char const * str) {
+    return (strhash_seeded(str, 0));
+}
+
+static unsigned long int identity(uint32_t const * key) {
+    return (*key);
+}
+
+//chi-square of the bucket counts, normalized: close to 1.0 for an uniform hash
+static double chi2(unsigned long int * counts) {
+    double expected = KEYS / (double)BUCKETS;
+    double sum = 0;
+    int i;
+    for (i = 0 ; i < BUCKETS ; i++) {
+        sum += (counts[i] - expected) * (counts[i] - expected) / expected;
+    }
+    return (sum / (BUCKETS - 1));
+}
+
+static void bench_strings(char const * name, t_hash_function hashf, char ** strs, unsigned long int bytes) {
+    static unsigned long int counts[BUCKETS];
+    unsigned long int t1, t2, sum = 0;
+    int i;
+    memset(counts, 0, sizeof(counts));
+    MICROSEC(t1);
+    for (i = 0 ; i < KEYS ; i++) {
+        unsigned long int h = hashf(strs[i]);
+        sum += h;
+        counts[h & (BUCKETS - 1)]++;
+    }
+    MICROSEC(t2);
+    printf("\t%-20s%8.1lf MB/s    chi2 %lf  (%lu)\n", name, bytes / (double)(t2 - t1), chi2(counts), sum & 1);
+}
+
+static void bench_ints(char const * name, t_hash_function hashf, uint32_t * ints) {
+    static unsigned long int counts[BUCKETS];
+    unsigned long int t1, t2, sum = 0;
+    int i;
+    memset(counts, 0, sizeof(counts));
+    MICROSEC(t1);
+    for (i = 0 ; i < KEYS ; i++) {
+        unsigned long int h = hashf(ints + i);
+        sum += h;
+        counts[h & (BUCKETS - 1)]++;
+    }
+    MICROSEC(t2);
+    printf("\t%-20s%8.1lf Mkeys/s  chi2 %lf  (%lu)\n", name, KEYS / (double)(t2 - t1), chi2(counts), sum & 1);
+}
+
+int main() {
+    char ** strs = (char **)malloc(sizeof(char *) * KEYS);
+    uint32_t * ints = (uint32_t *)malloc(sizeof(uint32_t) * KEYS);
+    unsigned long int bytes = 0;
+    int i;
+    for (i = 0 ; i < KEYS ; i++) {
+        char buffer[64];
+        sprintf(buffer, "identifier_%d", i);
+        strs[i] = strdup(buffer);
+        bytes += strlen(buffer);
+        //sequential keys with a stride: the worst case for low bits masking
+        ints[i] = (uint32_t)i << 10;
+    }
+
+    bench_strings("djb2", (t_hf)djb2, strs, bytes);
+    bench_strings("wyhash", (t_hf)wyhash, strs, bytes);
+    bench_ints("identity", (t_hf)identity, ints);
+    bench_ints("u32hash", (t_hf)u32hash, ints);
+
+    for (i = 0 ; i < KEYS ; i++) {
+        free(strs[i]);
+    }
+    free(strs);
+    free(ints);
+    return (0);
+}
+*/
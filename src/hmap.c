@@ -9,6 +9,34 @@
 
 #include "hmap.h"
 
+/** internal macro : add 'N' to an operation counter (if HMAP_STATS is defined, else it does nothing) */
+#ifdef HMAP_STATS
+# if defined(__GNUC__)
+#  define HMAP_COUNT(H, F, N) __atomic_fetch_add(&((H)->counters.F), (N), __ATOMIC_RELAXED)
+# else
+#  define HMAP_COUNT(H, F, N) ((H)->counters.F += (N))
+# endif
+#else
+# define HMAP_COUNT(H, F, N) ((void)(N))
+#endif
+
+/** bits of a bloom filter block (a cache line), and the number of bits needed to index one of them */
+#define HMAP_BLOOM_BLOCK (CACHE_LINE * 8)
+#define HMAP_BLOOM_BLOCK_SHIFT 9
+
+/**
+ *	internal function : allocate 'capacity' empty lists
+ */
+static t_list * hmap_new_values(unsigned long int capacity) {
+    unsigned long int size = sizeof(t_list) * capacity;
+    t_list * values = (t_list *)malloc(size);
+    if (values == NULL) {
+        return (NULL);
+    }
+    memset(values, 0, size);
+    return (values);
+}
+
 /**
  *	Create a new hashmap:
  *
@@ -26,12 +54,10 @@ t_hmap * hmap_new(unsigned long int const capacity,
         c = c << 1;
     }
 
-    unsigned long int size = sizeof(t_list) * c;
-    void * values = malloc(size);
+    t_list * values = hmap_new_values(c);
     if (values == NULL) {
         return (NULL);
     }
-    memset(values, 0, size);
 
     t_hmap * hmap = (t_hmap *)malloc(sizeof(t_hmap));
     if (hmap == NULL) {
@@ -40,16 +66,77 @@ t_hmap * hmap_new(unsigned long int const capacity,
     }
 
     hmap->values = values;
-    hmap->capacity = capacity;
+    hmap->capacity = c;
     hmap->size = 0;
+    hmap->old_values = NULL;
+    hmap->old_capacity = 0;
+    hmap->rehash_index = 0;
+    hmap->min_capacity = c;
     hmap->hashf = hashf;
     hmap->keycmpf = keycmpf;
     hmap->datafreef = datafreef;
     hmap->keyfreef = keyfreef;
+    hmap->keysizef = NULL;
+    hmap->dataindex = NULL;
+    hmap->bloom = NULL;
+    hmap->bloom_blocks = 0;
+    hmap->bloom_offset = 0;
+    hmap->bloom_capacity = 0;
+    hmap->bloom_count = 0;
+    hmap->slab = NULL;
+    hmap->slab_size = 0;
+#ifdef HMAP_STATS
+    memset(&(hmap->counters), 0, sizeof(t_hmap_counters));
+#endif
 
     return (hmap);
 }
 
+/**
+ *	Copy short keys inside the hash map nodes: keys comparison wont dereference the key pointers anymore.
+ *	The map must be empty. Return 1 on success, 0 elseway.
+ */
+int hmap_inline_keys(t_hmap * hmap, t_size_function keysizef) {
+    if (hmap->size != 0) {
+        return (0);
+    }
+    hmap->keysizef = keysizef;
+    return (1);
+}
+
+/**
+ *	internal function : free a node or a list head, unless it belongs to the slab of the map
+ */
+static void hmap_free_block(t_hmap * hmap, void * block) {
+    if (hmap->slab != NULL && (BYTE *)block >= (BYTE *)hmap->slab
+            && (BYTE *)block < (BYTE *)hmap->slab + hmap->slab_size) {
+        return ;
+    }
+    free(block);
+}
+
+/**
+ *	internal function : free every node of the list (and their data / key), and the list head
+ */
+static void hmap_delete_list(t_hmap * hmap, t_list * lst) {
+    t_list_node * lnode = lst->head->next;
+    while (lnode != lst->head) {
+        t_list_node * next = lnode->next;
+        t_hmap_node * node = (t_hmap_node *)(lnode + 1);
+        if (hmap->datafreef) {
+            hmap->datafreef(node->data);
+        }
+        if (hmap->keyfreef) {
+            hmap->keyfreef(node->key);
+        }
+        hmap_free_block(hmap, lnode);
+        lnode = next;
+    }
+    hmap_free_block(hmap, lst->head);
+    lst->head = NULL;
+    lst->size = 0;
+}
+
 /**
  *	Delete the hashmap from the heap
  *
@@ -59,25 +146,238 @@ t_hmap * hmap_new(unsigned long int const capacity,
  'myfree' if this is structure which contains multiple allocated fields
  */
 void hmap_delete(t_hmap * hmap) {
-    unsigned long int i = 0;
-    while (i < hmap->capacity) {
-        t_list * lst = hmap->values + i;
+    unsigned long int i;
+    for (i = 0 ; i < hmap->capacity ; i++) {
         //if the list has been initialized
-        if (lst->head) {
-            LIST_ITER_START(lst, t_hmap_node *, node) {
-                if (hmap->datafreef) {
-                    hmap->datafreef(node->data);
-                }
+        if (hmap->values[i].head) {
+            hmap_delete_list(hmap, hmap->values + i);
+        }
+    }
+    for (i = hmap->rehash_index ; i < hmap->old_capacity ; i++) {
+        if (hmap->old_values[i].head) {
+            hmap_delete_list(hmap, hmap->old_values + i);
+        }
+    }
+    if (hmap->dataindex) {
+        hmap_delete(hmap->dataindex);
+    }
+    if (hmap->bloom) {
+        bitmap_delete(hmap->bloom);
+    }
+    free(hmap->old_values);
+    free(hmap->values);
+    free(hmap->slab);
+    free(hmap);
+}
 
-                if (hmap->keyfreef) {
-                    hmap->keyfreef(node->key);
-                }				
+/**
+ *	internal function : return the list which holds (or should hold) the nodes of the given hash.
+ *	While resizing, the old lists which werent migrated yet are still used.
+ */
+static t_list * hmap_bucket(t_hmap * hmap, unsigned long int hash) {
+    if (hmap->old_values != NULL) {
+        unsigned long int old = hash & (hmap->old_capacity - 1);
+        if (old >= hmap->rehash_index) {
+            return (hmap->old_values + old);
+        }
+    }
+    return (hmap->values + (hash & (hmap->capacity - 1)));
+}
+
+/**
+ *	internal function : migrate up to 'n' non-empty old lists into the new ones.
+ *	Nodes are relinked, not copied, so pointers to node data stay valid.
+ */
+static void hmap_rehash_step(t_hmap * hmap, unsigned long int n) {
+    //bound the number of empty lists visited, so a step stays cheap on sparse maps
+    unsigned long int empty_visits = n * 10;
+
+    while (n > 0 && hmap->rehash_index < hmap->old_capacity) {
+        t_list * src = hmap->old_values + hmap->rehash_index;
+        if (src->head == NULL) {
+            ++hmap->rehash_index;
+            if (--empty_visits == 0) {
+                break ;
             }
-            LIST_ITER_END(lst, t_hmap_node *, node)
-			list_delete(lst);
+            continue ;
+        }
+
+        //initialize every destination list first: the old list is moved entirely, or not at all
+        //(until it is fully moved, 'hmap_bucket()' still sends its hashes to it)
+        LIST_ITER_START(src, t_hmap_node *, node) {
+            t_list * dst = hmap->values + (node->hash & (hmap->capacity - 1));
+            if (dst->head == NULL && !list_init(dst)) {
+                return ; //not enough memory, retry on next operation
+            }
+        }
+        LIST_ITER_END(src, t_hmap_node *, node)
+
+        while (src->size > 0) {
+            t_list_node * lnode = src->head->next;
+            t_hmap_node * node = (t_hmap_node *)(lnode + 1);
+            t_list * dst = hmap->values + (node->hash & (hmap->capacity - 1));
+            list_unlink_node(src, lnode);
+            list_add_node(dst, lnode);
+        }
+        hmap_free_block(hmap, src->head);
+        src->head = NULL;
+        ++hmap->rehash_index;
+        --n;
+    }
+
+    if (hmap->rehash_index >= hmap->old_capacity) {
+        free(hmap->old_values);
+        hmap->old_values = NULL;
+        hmap->old_capacity = 0;
+        hmap->rehash_index = 0;
+    }
+}
+
+/**
+ *	internal function : start migrating the map to 'capacity' lists.
+ *	Does nothing if a resize is already in progress.
+ */
+static void hmap_resize(t_hmap * hmap, unsigned long int capacity) {
+    if (hmap->old_values != NULL || capacity == hmap->capacity) {
+        return ;
+    }
+    t_list * values = hmap_new_values(capacity);
+    if (values == NULL) {
+        return ; //keep the current lists, the map still works with longer chains
+    }
+    hmap->old_values = hmap->values;
+    hmap->old_capacity = hmap->capacity;
+    hmap->rehash_index = 0;
+    hmap->values = values;
+    hmap->capacity = capacity;
+    HMAP_COUNT(hmap, resizes, 1);
+}
+
+/**
+ *	internal function : shrink the map if enough values were removed
+ */
+static void hmap_shrink(t_hmap * hmap) {
+    if (hmap->capacity <= hmap->min_capacity || hmap->capacity <= HMAP_MIN_CAPACITY) {
+        return ;
+    }
+    if (hmap->size >= hmap->capacity / HMAP_SHRINK_RATIO) {
+        return ;
+    }
+    //closest power of two which keeps the load factor under 1/2
+    unsigned long int c = hmap->min_capacity < HMAP_MIN_CAPACITY ? HMAP_MIN_CAPACITY : hmap->min_capacity;
+    while (c < hmap->size * 2) {
+        c = c << 1;
+    }
+    hmap_resize(hmap, c);
+}
+
+/**
+ *	internal function : return the index of the first bit of the bloom filter block of the hash,
+ *	and set 'bits' to the hash of the bits of the block to set (HMAP_BLOOM_BLOCK_SHIFT bits per bit to set)
+ */
+static unsigned long int hmap_bloom_block(t_hmap * hmap, unsigned long int hash, uint64_t * bits) {
+    *bits = hash_u64((uint64_t)hash);
+    return (hmap->bloom_offset + (hash_u64(*bits) & (hmap->bloom_blocks - 1)) * HMAP_BLOOM_BLOCK);
+}
+
+/**
+ *	internal function : add the hash to the bloom filter
+ */
+static void hmap_bloom_add(t_hmap * hmap, unsigned long int hash) {
+    uint64_t bits;
+    unsigned long int block = hmap_bloom_block(hmap, hash, &bits);
+    int i;
+    for (i = 0 ; i < HMAP_BLOOM_HASHES ; i++) {
+        bitmap_set(hmap->bloom, block + (bits & (HMAP_BLOOM_BLOCK - 1)));
+        bits = bits >> HMAP_BLOOM_BLOCK_SHIFT;
+    }
+    hmap->bloom_count++;
+}
+
+/**
+ *	internal function : return 0 if no key of the map has this hash, 1 if one may have it
+ */
+static int hmap_bloom_test(t_hmap * hmap, unsigned long int hash) {
+    uint64_t bits;
+    unsigned long int block = hmap_bloom_block(hmap, hash, &bits);
+    int i;
+    for (i = 0 ; i < HMAP_BLOOM_HASHES ; i++) {
+        if (!bitmap_get(hmap->bloom, block + (bits & (HMAP_BLOOM_BLOCK - 1)))) {
+            return (0);
         }
-        ++i;
+        bits = bits >> HMAP_BLOOM_BLOCK_SHIFT;
+    }
+    return (1);
+}
+
+/**
+ *	internal function : add the hashes of the lists [from, to[ to the bloom filter
+ */
+static void hmap_bloom_add_lists(t_hmap * hmap, t_list * values, unsigned long int from, unsigned long int to) {
+    unsigned long int i;
+    for (i = from ; i < to ; i++) {
+        t_list * lst = values + i;
+        LIST_ITER_START(lst, t_hmap_node *, node) {
+            hmap_bloom_add(hmap, node->hash);
+        }
+        LIST_ITER_END(lst, t_hmap_node *, node)
+    }
+}
+
+/**
+ *	internal function : (re)build the bloom filter from the values of the map, with room for
+ *	twice as many values (and at least as many as lists, so rebuilds stay rare on sparse maps).
+ *	return 1 on success, 0 elseway (and the current filter is kept: it has more false positives, but no false negatives)
+ */
+static int hmap_bloom_build(t_hmap * hmap) {
+    unsigned long int values = hmap->size * 2 > hmap->capacity ? hmap->size * 2 : hmap->capacity;
+    unsigned long int blocks = 1;
+    while (blocks * HMAP_BLOOM_BLOCK < values * HMAP_BLOOM_BITS) {
+        blocks = blocks << 1;
     }
+
+    //one more block, so the first block can be moved to a cache line boundary
+    t_bitmap * bloom = bitmap_new((blocks + 1) * HMAP_BLOOM_BLOCK);
+    if (bloom == NULL) {
+        return (0);
+    }
+    bitmap_zeroes(bloom);
+    if (hmap->bloom) {
+        bitmap_delete(hmap->bloom);
+    }
+    hmap->bloom = bloom;
+    hmap->bloom_blocks = blocks;
+    hmap->bloom_offset = ((CACHE_LINE - (uintptr_t)(bloom + 1) % CACHE_LINE) % CACHE_LINE) * 8;
+    hmap->bloom_capacity = blocks * HMAP_BLOOM_BLOCK / HMAP_BLOOM_BITS;
+    hmap->bloom_count = 0;
+
+    hmap_bloom_add_lists(hmap, hmap->values, 0, hmap->capacity);
+    if (hmap->old_values != NULL) {
+        hmap_bloom_add_lists(hmap, hmap->old_values, hmap->rehash_index, hmap->old_capacity);
+    }
+    return (1);
+}
+
+/**
+ *	internal function : rebuild the bloom filter if it holds more hashes than planned,
+ *	or if half of its capacity is used by hashes of removed values
+ */
+static void hmap_bloom_refresh(t_hmap * hmap) {
+    if (hmap->bloom_count > hmap->bloom_capacity
+            || hmap->bloom_count - hmap->size > hmap->bloom_capacity / 2) {
+        hmap_bloom_build(hmap);
+    }
+}
+
+/**
+ *	Add a bloom filter in front of the lists, for maps where most searched keys are missing.
+ *	return 1 if the filter was built, 0 elseway
+ */
+int hmap_bloom_filter(t_hmap * hmap) {
+    if (hmap->bloom) {
+        return (1);
+    }
+    return (hmap_bloom_build(hmap));
 }
 
 /**
@@ -92,22 +392,131 @@ void hmap_delete(t_hmap * hmap) {
  */
 void const * hmap_insert(t_hmap * hmap, void const * data, void const * key)
 {
-    unsigned long int hash = hmap->hashf(key); //get the hash for this key
-    unsigned long int addr = hash & (hmap->capacity - 1); //get the array list from the hash
+    return (hmap_insert_hashed(hmap, data, key, hmap->hashf(key)));
+}
 
-    t_hmap_node node = {hash, data, key}; //set the node buffer
+/**
+ *	internal function : add a value to the given list (the list of its hash), and return its node
+ */
+static t_hmap_node * hmap_add_node(t_hmap * hmap, t_list * lst, void const * data, void const * key, unsigned long int hash)
+{
+    //set the node buffer. If keys are inlined, it is followed by the size of the key copy
+    //(0 if the key is too long), and by the copy
+    union {
+        t_hmap_node node;
+        BYTE bytes[sizeof(t_hmap_node) + sizeof(unsigned long int) + HMAP_INLINE_KEY_SIZE];
+    } buffer = {{hash, data, key}};
+    unsigned long int extra = 0;
+    if (hmap->keysizef) {
+        unsigned long int keysize = hmap->keysizef(key);
+        if (keysize > HMAP_INLINE_KEY_SIZE) {
+            keysize = 0;
+        }
+        memcpy(buffer.bytes + sizeof(t_hmap_node), &keysize, sizeof(unsigned long int));
+        memcpy(buffer.bytes + sizeof(t_hmap_node) + sizeof(unsigned long int), key, keysize);
+        extra = sizeof(unsigned long int) + keysize;
+    }
 
-    t_list * lst = hmap->values + addr; //get the list from it address
     //if the list hasnt already been initialized
-    if (lst->head == NULL) {
-        list_init(lst); //initialize it				
+    if (lst->head == NULL && !list_init(lst)) {
+        return (NULL);
+    }
+    t_hmap_node * node = (t_hmap_node *)list_add(lst, &buffer, sizeof(t_hmap_node) + extra); //add the node to the list
+    if (node == NULL) {
+        return (NULL);
+    }
+    if (hmap->dataindex && hmap_insert(hmap->dataindex, node, data) == NULL) {
+        list_remove_node(lst, (t_list_node *)node - 1);
+        return (NULL);
     }
-    list_add(lst, &node, sizeof(t_hmap_node)); //add the node to the list
 
     hmap->size++;
+    HMAP_COUNT(hmap, inserts, 1);
+    if (hmap->size > hmap->capacity * HMAP_MAX_LOAD) {
+        hmap_resize(hmap, hmap->capacity << 1);
+    }
+    if (hmap->bloom) {
+        hmap_bloom_add(hmap, hash);
+        hmap_bloom_refresh(hmap);
+    }
+    return (node);
+}
+
+/**
+ *	internal function : insert a value, and return its node
+ */
+static t_hmap_node * hmap_insert_node(t_hmap * hmap, void const * data, void const * key, unsigned long int hash)
+{
+    if (hmap->old_values != NULL) {
+        hmap_rehash_step(hmap, HMAP_REHASH_STEP);
+    }
+    return (hmap_add_node(hmap, hmap_bucket(hmap, hash), data, key, hash));
+}
+
+/**
+ *	Insert a value into the hashmap, with the already computed hash of the key
+ */
+void const * hmap_insert_hashed(t_hmap * hmap, void const * data, void const * key, unsigned long int hash)
+{
+    if (hmap_insert_node(hmap, data, key, hash) == NULL) {
+        return (NULL);
+    }
     return (data); //return the data
 }
 
+/**
+ *	Insert a value into the hashmap, and return its node: a handle to remove it with 'hmap_remove_node()'.
+ *	NULL if it wasnt inserted
+ */
+t_hmap_node * hmap_insert_handle(t_hmap * hmap, void const * data, void const * key)
+{
+    return (hmap_insert_node(hmap, data, key, hmap->hashf(key)));
+}
+
+/**
+ *	internal function : the key to compare with: the copy following the node if the key was inlined,
+ *	the key pointer elseway
+ */
+static void const * hmap_node_key(t_hmap * hmap, t_hmap_node const * node) {
+    if (hmap->keysizef && *(unsigned long int const *)(node + 1) != 0) {
+        return ((unsigned long int const *)(node + 1) + 1);
+    }
+    return (node->key);
+}
+
+/**
+ *	internal function : return the list node which holds the key, NULL if there is none.
+ *	The saved hashes are compared first, so 'keycmpf' is almost only called on the matching key.
+ */
+static t_list_node * hmap_find_node(t_hmap * hmap, t_list * lst, unsigned long int hash, void const * key) {
+    unsigned long int probes = 0;
+    if (hmap->bloom && !hmap_bloom_test(hmap, hash)) {
+        HMAP_COUNT(hmap, misses, 1);
+        HMAP_COUNT(hmap, filtered, 1);
+        return (NULL);
+    }
+    if (lst->size == 0) {
+        HMAP_COUNT(hmap, misses, 1);
+        return (NULL);
+    }
+
+    //so compare the exact key to find the wanted data
+    LIST_ITER_START(lst, t_hmap_node *, node) {
+        ++probes;
+        if (node->hash == hash) {
+            if (hmap->keycmpf(key, hmap_node_key(hmap, node)) == 0) {
+                HMAP_COUNT(hmap, hits, 1);
+                HMAP_COUNT(hmap, hit_probes, probes);
+                return (__node);
+            }
+        }
+    }
+    LIST_ITER_END(lst, t_hmap_node *, node)
+    HMAP_COUNT(hmap, misses, 1);
+    HMAP_COUNT(hmap, miss_probes, probes);
+    return (NULL);
+}
+
 /**
  *	Get data from the hashmap
  *
@@ -115,23 +524,183 @@ void const * hmap_insert(t_hmap * hmap, void const * data, void const * key)
  *	key  : the node's key to find
  */
 void * hmap_get(t_hmap * hmap, void const * key) {
-    unsigned long int hash = hmap->hashf(key); //get the hash for this key
-    unsigned long int addr = hash & (hmap->capacity - 1); //get the lst list from the hash
+    return (hmap_get_hashed(hmap, key, hmap->hashf(key)));
+}
+
+/**
+ *	Get data from the hashmap, with the already computed hash of the key
+ */
+void * hmap_get_hashed(t_hmap * hmap, void const * key, unsigned long int hash) {
+    if (hmap->old_values != NULL) {
+        hmap_rehash_step(hmap, HMAP_REHASH_STEP);
+    }
+    return (hmap_lookup_hashed(hmap, key, hash));
+}
 
-    t_list * lst = hmap->values + addr; //list of collision for this key hash
+/**
+ *	Same as 'hmap_get_hashed()', but no list is migrated if the map is resizing:
+ *	the map isnt modified, so concurrent lookups are safe
+ */
+void * hmap_lookup_hashed(t_hmap * hmap, void const * key, unsigned long int hash) {
+    t_list * lst = hmap_bucket(hmap, hash); //list of collision for this key hash
 
-    if (lst->size == 0) {
+    t_list_node * lnode = hmap_find_node(hmap, lst, hash, key);
+    if (lnode == NULL) {
         return (NULL);
     }
+    return ((void *)((t_hmap_node *)(lnode + 1))->data);
+}
 
-    //so compare the exact key to find the wanted data
-    LIST_ITER_START(lst, t_hmap_node *, node) {
-        if (hmap->keycmpf(key, node->key) == 0) {
-            return ((void *)node->data);
+/**
+ *	Get the data of 'n' keys: 'datas[i]' is set to the data of 'keys[i]', or NULL if it isnt found.
+ *	return the number of keys found
+ *
+ *	The keys are processed by groups of HMAP_BATCH_SIZE: every hash is computed, then every list,
+ *	list head and first node is prefetched (stage by stage), and only then the lists are walked.
+ *	The cache misses of the group overlap instead of being waited one after the other.
+ */
+unsigned long int hmap_get_batch(t_hmap * hmap, void const ** keys, void ** datas, unsigned long int n) {
+    unsigned long int hashes[HMAP_BATCH_SIZE];
+    t_list * lsts[HMAP_BATCH_SIZE];
+    unsigned long int found = 0;
+    unsigned long int i;
+
+    for (i = 0 ; i < n ; i += HMAP_BATCH_SIZE) {
+        unsigned long int count = n - i < HMAP_BATCH_SIZE ? n - i : HMAP_BATCH_SIZE;
+        unsigned long int j;
+
+        if (hmap->old_values != NULL) {
+            hmap_rehash_step(hmap, HMAP_REHASH_STEP);
+        }
+
+        //hash every key, and prefetch their lists
+        for (j = 0 ; j < count ; j++) {
+            hashes[j] = hmap->hashf(keys[i + j]);
+            lsts[j] = hmap_bucket(hmap, hashes[j]);
+            PREFETCH(lsts[j]);
+        }
+        //prefetch the lists heads
+        for (j = 0 ; j < count ; j++) {
+            PREFETCH(lsts[j]->head);
+        }
+        //prefetch the first node of every list
+        for (j = 0 ; j < count ; j++) {
+            if (lsts[j]->size != 0) {
+                PREFETCH(lsts[j]->head->next);
+            }
+        }
+        //resolve
+        for (j = 0 ; j < count ; j++) {
+            t_list_node * lnode = hmap_find_node(hmap, lsts[j], hashes[j], keys[i + j]);
+            if (lnode == NULL) {
+                datas[i + j] = NULL;
+            } else {
+                datas[i + j] = (void *)((t_hmap_node *)(lnode + 1))->data;
+                ++found;
+            }
         }
     }
-    LIST_ITER_END(lst, t_hmap_node *, node)
-	return (NULL);
+    return (found);
+}
+
+/**
+ *	Insert 'n' values into the hashmap: 'datas[i]' is inserted with the key 'keys[i]'.
+ *	return the number of values inserted
+ *
+ *	As for 'hmap_get_batch()', the hashes are computed and the lists prefetched
+ *	by groups of HMAP_BATCH_SIZE before the insertions.
+ */
+unsigned long int hmap_insert_batch(t_hmap * hmap, void const ** datas, void const ** keys, unsigned long int n) {
+    unsigned long int hashes[HMAP_BATCH_SIZE];
+    unsigned long int inserted = 0;
+    unsigned long int i;
+
+    for (i = 0 ; i < n ; i += HMAP_BATCH_SIZE) {
+        unsigned long int count = n - i < HMAP_BATCH_SIZE ? n - i : HMAP_BATCH_SIZE;
+        unsigned long int j;
+
+        //hash every key, and prefetch their lists
+        for (j = 0 ; j < count ; j++) {
+            hashes[j] = hmap->hashf(keys[i + j]);
+            PREFETCH(hmap_bucket(hmap, hashes[j]));
+        }
+        //prefetch the lists heads (the new node is linked between the head and its previous node)
+        for (j = 0 ; j < count ; j++) {
+            PREFETCH(hmap_bucket(hmap, hashes[j])->head);
+        }
+        //insert: the lists are searched again, as an insertion may resize the map
+        for (j = 0 ; j < count ; j++) {
+            if (hmap_insert_hashed(hmap, datas[i + j], keys[i + j], hashes[j]) != NULL) {
+                ++inserted;
+            }
+        }
+    }
+    return (inserted);
+}
+
+/**
+ *	internal function : remove the entry of 'node' from the data index
+ *	(the index may hold many nodes for a same data pointer, if it was inserted many times)
+ */
+static void hmap_index_remove(t_hmap * index, t_hmap_node * node) {
+    unsigned long int hash = index->hashf(node->data);
+    t_list * lst = hmap_bucket(index, hash);
+    LIST_ITER_START(lst, t_hmap_node *, entry) {
+        if (entry->data == node && entry->key == node->data) {
+            list_remove_node(lst, __node);
+            index->size--;
+            return ;
+        }
+    }
+    LIST_ITER_END(lst, t_hmap_node *, entry)
+}
+
+/**
+ *	internal function : remove the node from the list, free it (and its data / key)
+ */
+static void hmap_remove_node_from(t_hmap * hmap, t_list * lst, t_list_node * lnode) {
+    t_hmap_node * node = (t_hmap_node *)(lnode + 1);
+    void const * data = node->data;
+    void const * key = node->key;
+
+    if (hmap->dataindex) {
+        hmap_index_remove(hmap->dataindex, node);
+    }
+    list_unlink_node(lst, lnode);
+    hmap_free_block(hmap, lnode);
+    hmap->size--;
+    HMAP_COUNT(hmap, removes, 1);
+    if (hmap->bloom) {
+        hmap_bloom_refresh(hmap);
+    }
+
+    if (hmap->datafreef) {
+        hmap->datafreef(data);
+    }
+
+    if (hmap->keyfreef) {
+        hmap->keyfreef(key);
+    }
+}
+
+/**
+ *	internal function : search the data pointer in the given lists
+ */
+static int hmap_remove_data_from(t_hmap * hmap, t_list * values,
+        unsigned long int from, unsigned long int to, void const * data) {
+    unsigned long int i;
+    for (i = from ; i < to ; i++) {
+        t_list * lst = values + i;
+        LIST_ITER_START(lst, t_hmap_node *, node) {
+            if (node->data == data) {
+                //__node is the current LIST_ITER_START node of the linked list
+                hmap_remove_node_from(hmap, lst, __node);
+                return (1);
+            }
+        }
+        LIST_ITER_END(lst, t_hmap_node *, node)
+    }
+    return (0);
 }
 
 /**
@@ -141,30 +710,55 @@ void * hmap_get(t_hmap * hmap, void const * key) {
  *	data : pointer to the data
  */
 int hmap_remove_data(t_hmap * hmap, void const * data) {
-    unsigned long int i = 0;
-    while (i < hmap->capacity) {
-        t_list * lst = hmap->values + i;
-        LIST_ITER_START(lst, t_hmap_node *, node) {
-            if (node->data == data) {
-                //__node is the current LIST_ITER_START node of the linked list
-                list_remove_node(lst, __node);
-                hmap->size--;
-
-                if (hmap->datafreef) {
-                    hmap->datafreef(node->key);
-                }
+    if (hmap->dataindex) {
+        t_hmap_node * node = (t_hmap_node *)hmap_get(hmap->dataindex, data);
+        if (node == NULL) {
+            return (0);
+        }
+        hmap_remove_node(hmap, node);
+        return (1);
+    }
+    if (hmap_remove_data_from(hmap, hmap->values, 0, hmap->capacity, data)
+            || (hmap->old_values != NULL
+                && hmap_remove_data_from(hmap, hmap->old_values, hmap->rehash_index, hmap->old_capacity, data))) {
+        hmap_shrink(hmap);
+        return (1);
+    }
+    return (0);
+}
 
-                if (hmap->keyfreef) {
-                    hmap->keyfreef(node->key);
-                }
+/**
+ *	Remove the node (returned by 'hmap_insert_handle()') from the hash map, in constant time
+ */
+void hmap_remove_node(t_hmap * hmap, t_hmap_node * node) {
+    //nodes are never moved in memory, only relinked from a list to another when the map resizes:
+    //the node is in the list of its hash
+    hmap_remove_node_from(hmap, hmap_bucket(hmap, node->hash), (t_list_node *)node - 1);
+    hmap_shrink(hmap);
+}
 
-                return (1);
-            }
+/**
+ *	Index the nodes by their data pointer, so 'hmap_remove_data()' runs in constant time
+ *	(at the cost of an entry in the index for each value).
+ *	return 1 if the index was built, 0 elseway
+ */
+int hmap_index_data(t_hmap * hmap) {
+    if (hmap->dataindex) {
+        return (1);
+    }
+    t_hmap * index = hmap_new(hmap->capacity, ptrhash, ptrcmp, NULL, NULL);
+    if (index == NULL) {
+        return (0);
+    }
+    HMAP_ITER_START(hmap, void const *, data) {
+        if (hmap_insert(index, node, data) == NULL) {
+            hmap_delete(index);
+            return (0);
         }
-        LIST_ITER_END(array, t_hmap_node *, node)
-		++i;
     }
-    return (0);
+    HMAP_ITER_END(hmap, void const *, data)
+    hmap->dataindex = index;
+    return (1);
 }
 
 /**
@@ -175,35 +769,249 @@ int hmap_remove_data(t_hmap * hmap, void const * data) {
  *	key  : pointer to the key
  */
 int hmap_remove_key(t_hmap * hmap, void const * key) {
-    unsigned long int hash = hmap->hashf(key); //get the hash for this key
-    unsigned long int addr = hash & (hmap->capacity - 1); //get the array list from the hash
+    return (hmap_remove_key_hashed(hmap, key, hmap->hashf(key)));
+}
 
-    t_list * lst = hmap->values + addr; //lst of collision for this key hash
+/**
+ *	Same as 'hmap_remove_key()', with the already computed hash of the key
+ */
+int hmap_remove_key_hashed(t_hmap * hmap, void const * key, unsigned long int hash) {
+    if (hmap->old_values != NULL) {
+        hmap_rehash_step(hmap, HMAP_REHASH_STEP);
+    }
 
-    if (lst->size == 0) {
+    t_list * lst = hmap_bucket(hmap, hash); //lst of collision for this key hash
+
+    t_list_node * lnode = hmap_find_node(hmap, lst, hash, key);
+    if (lnode == NULL) {
         return (0);
     }
+    hmap_remove_node_from(hmap, lst, lnode);
+    hmap_shrink(hmap);
+    return (1);
+}
 
-    //so compare the exact key to find the wanted data
-    LIST_ITER_START(lst, t_hmap_node *, node) {
-        if (hmap->keycmpf(key, node->key) == 0) {
-            //__node is the current LIST_ITER_START node of the linked list
-			list_remove_node(lst, __node);
-			hmap->size--;
+/**
+ *	internal function : set the data of a node, and keep the data index up to date
+ *	return 1 on success, 0 elseway (and the node is left unchanged)
+ */
+static int hmap_set_node_data(t_hmap * hmap, t_hmap_node * node, void const * data) {
+    if (hmap->dataindex && data != node->data) {
+        //the new entry is inserted first, so a failure leaves the index as it was
+        if (hmap_insert(hmap->dataindex, node, data) == NULL) {
+            return (0);
+        }
+        hmap_index_remove(hmap->dataindex, node);
+    }
+    node->data = data;
+    return (1);
+}
 
+/**
+ *	internal function : find the node of the key, after a single rehash step.
+ *	'lst' is set to the list of the key hash.
+ */
+static t_list_node * hmap_resolve(t_hmap * hmap, void const * key, unsigned long int hash, t_list ** lst) {
+    if (hmap->old_values != NULL) {
+        hmap_rehash_step(hmap, HMAP_REHASH_STEP);
+    }
+    *lst = hmap_bucket(hmap, hash);
+    return (hmap_find_node(hmap, *lst, hash, key));
+}
+
+/**
+ *	Get the data of the key, or insert the given value if the key isnt found
+ */
+void * hmap_get_or_insert(t_hmap * hmap, void const * data, void const * key) {
+    t_hmap_node * node = hmap_get_or_insert_handle(hmap, data, key);
+    if (node == NULL) {
+        return (NULL);
+    }
+    return ((void *)node->data);
+}
+
+/**
+ *	Same as 'hmap_get_or_insert()', but return the node of the key (NULL if the value couldnt be inserted)
+ */
+t_hmap_node * hmap_get_or_insert_handle(t_hmap * hmap, void const * data, void const * key) {
+    unsigned long int hash = hmap->hashf(key);
+    t_list * lst;
+    t_list_node * lnode = hmap_resolve(hmap, key, hash, &lst);
+    if (lnode != NULL) {
+        return ((t_hmap_node *)(lnode + 1));
+    }
+    return (hmap_add_node(hmap, lst, data, key, hash));
+}
+
+/**
+ *	Insert the value, or replace the data and key of the value which has the same key
+ */
+void const * hmap_upsert(t_hmap * hmap, void const * data, void const * key) {
+    unsigned long int hash = hmap->hashf(key);
+    t_list * lst;
+    t_list_node * lnode = hmap_resolve(hmap, key, hash, &lst);
+    if (lnode == NULL) {
+        return (hmap_add_node(hmap, lst, data, key, hash) == NULL ? NULL : data);
+    }
+
+    t_hmap_node * node = (t_hmap_node *)(lnode + 1);
+    void const * olddata = node->data;
+    void const * oldkey = node->key;
+    if (!hmap_set_node_data(hmap, node, data)) {
+        return (NULL);
+    }
+    //the keys are equal: the inlined copy (if any) is still valid
+    node->key = key;
+
+    if (hmap->datafreef && olddata != data) {
+        hmap->datafreef(olddata);
+    }
+    if (hmap->keyfreef && oldkey != key) {
+        hmap->keyfreef(oldkey);
+    }
+    return (data);
+}
+
+/**
+ *	Update the data of a key in place, with 'updatef(data, param)'
+ */
+void * hmap_update(t_hmap * hmap, void const * key, t_update_function updatef, void * param) {
+    unsigned long int hash = hmap->hashf(key);
+    t_list * lst;
+    t_list_node * lnode = hmap_resolve(hmap, key, hash, &lst);
+    if (lnode == NULL) {
+        void * data = updatef(NULL, param);
+        if (data == NULL) {
+            return (NULL);
+        }
+        if (hmap_add_node(hmap, lst, data, key, hash) == NULL) {
+            //the caller never sees the new data: free it
             if (hmap->datafreef) {
-                hmap->datafreef(node->key);
+                hmap->datafreef(data);
             }
+            return (NULL);
+        }
+        return (data);
+    }
 
-            if (hmap->keyfreef) {
-                hmap->keyfreef(node->key);
+    t_hmap_node * node = (t_hmap_node *)(lnode + 1);
+    void const * olddata = node->data;
+    void * data = updatef((void *)olddata, param);
+    if (data == NULL) {
+        //the key is removed (its old data and key are freed)
+        hmap_remove_node_from(hmap, lst, lnode);
+        hmap_shrink(hmap);
+        return (NULL);
+    }
+    if (data != olddata) {
+        if (!hmap_set_node_data(hmap, node, data)) {
+            //the key keeps its old data
+            if (hmap->datafreef) {
+                hmap->datafreef(data);
             }
+            return (NULL);
+        }
+        if (hmap->datafreef) {
+            hmap->datafreef(olddata);
+        }
+    }
+    return (data);
+}
+
+/**
+ *	internal function : add the chains of the lists [from, to[ to the statistics.
+ *	'hits' is increased by the probes needed to find every value, and 'misses' by
+ *	the probes needed to search a missing key hashed like each value
+ */
+static void hmap_stats_lists(t_hmap * hmap, t_hmap_stats * stats, t_list * values,
+        unsigned long int from, unsigned long int to, double * hits, double * misses) {
+    unsigned long int i;
+    for (i = from ; i < to ; i++) {
+        t_list * lst = values + i;
+        unsigned long int length = lst->head == NULL ? 0 : lst->size;
+        stats->chains[length < HMAP_STATS_HISTOGRAM ? length : HMAP_STATS_HISTOGRAM - 1]++;
+        if (length > stats->longest_chain) {
+            stats->longest_chain = length;
+        }
+        //the k-th node of a list is found after k probes
+        *hits += (double)length * (double)(length + 1) / 2.0;
+        //a missing key is compared to every node of its list
+        *misses += (double)length * (double)length;
+        if (lst->head != NULL) {
+            stats->bytes += sizeof(t_list_node);
+            LIST_ITER_START(lst, t_hmap_node *, node) {
+                stats->bytes += sizeof(t_list_node) + sizeof(t_hmap_node);
+                if (hmap->keysizef) {
+                    stats->bytes += sizeof(unsigned long int) + *(unsigned long int const *)(node + 1);
+                }
+            }
+            LIST_ITER_END(lst, t_hmap_node *, node)
+        }
+    }
+    stats->lists += to - from;
+    stats->bytes += sizeof(t_list) * (to - from);
+}
+
+/**
+ *	Get statistics about the map
+ */
+void hmap_stats(t_hmap * hmap, t_hmap_stats * stats) {
+    memset(stats, 0, sizeof(t_hmap_stats));
+    stats->size = hmap->size;
+    stats->bytes = sizeof(t_hmap);
+
+    double hits = 0;
+    double misses = 0;
+    hmap_stats_lists(hmap, stats, hmap->values, 0, hmap->capacity, &hits, &misses);
+    if (hmap->old_values != NULL) {
+        hmap_stats_lists(hmap, stats, hmap->old_values, hmap->rehash_index, hmap->old_capacity, &hits, &misses);
+        //the migrated old lists are still allocated
+        stats->bytes += sizeof(t_list) * hmap->rehash_index;
+    }
 
-            return (1);
+    stats->load_factor = (double)hmap->size / (double)stats->lists;
+    stats->empty_ratio = (double)stats->chains[0] / (double)stats->lists;
+    stats->probes_per_hit = hmap->size ? hits / (double)hmap->size : 0;
+    stats->probes_per_miss = hmap->size ? misses / (double)hmap->size : 0;
+
+    if (hmap->dataindex) {
+        t_hmap_stats index;
+        hmap_stats(hmap->dataindex, &index);
+        stats->bytes += index.bytes;
+    }
+    if (hmap->bloom) {
+        stats->bytes += sizeof(t_bitmap) + hmap->bloom->size * sizeof(BITMAP_UNIT);
+    }
+
+#ifdef HMAP_STATS
+    stats->counting = 1;
+    stats->counters = hmap->counters;
+#endif
+}
+
+/**
+ *	Write the statistics in a readable form to the given file
+ */
+void hmap_stats_print(t_hmap_stats const * stats, FILE * file) {
+    fprintf(file, "size: %lu, lists: %lu, load factor: %.3f, empty lists: %.1f%%, bytes: %lu\n",
+            stats->size, stats->lists, stats->load_factor, stats->empty_ratio * 100.0, stats->bytes);
+    fprintf(file, "probes per hit: %.3f, per miss: %.3f, longest chain: %lu\n",
+            stats->probes_per_hit, stats->probes_per_miss, stats->longest_chain);
+    fprintf(file, "chains:");
+    int i;
+    for (i = 0 ; i < HMAP_STATS_HISTOGRAM ; i++) {
+        if (stats->chains[i] != 0) {
+            fprintf(file, " [%d%s]=%lu", i, i == HMAP_STATS_HISTOGRAM - 1 ? "+" : "", stats->chains[i]);
         }
     }
-    LIST_ITER_END(array, t_hmap_node *, node)
-	return (0);
+    fprintf(file, "\n");
+    if (stats->counting) {
+        t_hmap_counters const * c = &(stats->counters);
+        fprintf(file, "hits: %lu (%.3f probes), misses: %lu (%.3f probes, %lu filtered), inserts: %lu, removes: %lu, resizes: %lu\n",
+                c->hits, c->hits ? (double)c->hit_probes / (double)c->hits : 0.0,
+                c->misses, c->misses ? (double)c->miss_probes / (double)c->misses : 0.0, c->filtered,
+                c->inserts, c->removes, c->resizes);
+    }
 }
 
 /**
@@ -213,21 +1021,21 @@ unsigned long int strhash(char const * str) {
     if (str == NULL) {
         return (0);
     }
-
-    unsigned long int hash = 5381;
-    int c;
-    while ((c = *str) != '\0') {
-        hash = ((hash << 5) + hash) + c;
-        str++;
-    }
-    return (hash);
+    return (hash_bytes(str, strlen(str), 0));
 }
 
 /**
  *	Default hash for an integer
  */
 unsigned long int inthash(int const value) {
-    return (value);
+    return (hash_u32((uint32_t)value));
+}
+
+/**
+ *	Size of a string key, including its '\0'
+ */
+unsigned long int strsize(char const * str) {
+    return (strlen(str) + 1);
 }
 
 /*
@@ -0,0 +1,158 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "hmap.h"
+#include "parallel.h"
+
+/** size of a node in the slab: the list node, followed by the hash map node */
+#define HMAP_BUILD_NODE_SIZE (sizeof(t_list_node) + sizeof(t_hmap_node))
+
+typedef struct  s_hmap_build {
+    t_hmap * hmap; //the map being built
+    void const ** keys; //the keys to insert
+    void const ** datas; //the data to insert
+    unsigned long int n; //number of values
+    unsigned long int * hashes; //hash of every key
+    size_t * counts; //'counts[t * partitions + p]' : values of the thread 't' in the partition 'p', then index of their next node
+    size_t * firsts; //index of the first node of every partition (and 'n' after the last one)
+    unsigned int threads; //number of threads
+    unsigned long int partitions; //number of partitions (a power of two, at most the number of lists)
+    unsigned int shift; //the partition of the list 'l' is 'l >> shift'
+    BYTE * nodes; //the nodes, in the slab, ordered by partition
+    t_list_node * heads; //the lists heads, in the slab
+    unsigned long int next_partition; //next partition to link (taken by the threads as they finish)
+}               t_hmap_build;
+
+/**
+ *	internal function : partition of a hash
+ */
+static unsigned long int hmap_build_partition(t_hmap_build * build, unsigned long int hash) {
+    return ((hash & (build->hmap->capacity - 1)) >> build->shift);
+}
+
+/**
+ *	internal function (phase 1) : hash the keys of the thread range, and count the values of each partition
+ */
+static void hmap_build_hash(void * state, unsigned int thread) {
+    t_hmap_build * build = (t_hmap_build *)state;
+    size_t * counts = build->counts + thread * build->partitions;
+    unsigned long int to = parallel_from(build->n, build->threads, thread + 1);
+    unsigned long int i;
+    for (i = parallel_from(build->n, build->threads, thread) ; i < to ; i++) {
+        unsigned long int hash = build->hmap->hashf(build->keys[i]);
+        build->hashes[i] = hash;
+        counts[hmap_build_partition(build, hash)]++;
+    }
+}
+
+/**
+ *	internal function (phase 2) : write the nodes of the thread range in their partition
+ *	(in order: the values of a list are linked as they were given)
+ */
+static void hmap_build_scatter(void * state, unsigned int thread) {
+    t_hmap_build * build = (t_hmap_build *)state;
+    size_t * counts = build->counts + thread * build->partitions;
+    unsigned long int to = parallel_from(build->n, build->threads, thread + 1);
+    unsigned long int i;
+    for (i = parallel_from(build->n, build->threads, thread) ; i < to ; i++) {
+        unsigned long int hash = build->hashes[i];
+        unsigned long int index = counts[hmap_build_partition(build, hash)]++;
+        t_hmap_node node = {hash, build->datas[i], build->keys[i]};
+        memcpy(build->nodes + index * HMAP_BUILD_NODE_SIZE + sizeof(t_list_node), &node, sizeof(t_hmap_node));
+    }
+}
+
+/**
+ *	internal function (phase 3) : link the nodes of the partitions into their lists.
+ *	A partition holds a range of lists, so no other thread touches them.
+ */
+static void hmap_build_link(void * state, unsigned int thread) {
+    t_hmap_build * build = (t_hmap_build *)state;
+    t_hmap * hmap = build->hmap;
+    unsigned long int p;
+    (void)thread;
+    while ((p = __atomic_fetch_add(&(build->next_partition), 1, __ATOMIC_RELAXED)) < build->partitions) {
+        unsigned long int i;
+        for (i = build->firsts[p] ; i < build->firsts[p + 1] ; i++) {
+            t_list_node * lnode = (t_list_node *)(build->nodes + i * HMAP_BUILD_NODE_SIZE);
+            unsigned long int index = ((t_hmap_node *)(lnode + 1))->hash & (hmap->capacity - 1);
+            t_list * lst = hmap->values + index;
+            if (lst->head == NULL) {
+                lst->head = build->heads + index;
+                lst->head->next = lst->head;
+                lst->head->prev = lst->head;
+            }
+            list_add_node(lst, lnode);
+        }
+    }
+}
+
+/**
+ *	Build a hash map holding 'n' values: 'datas[i]' is inserted with the key 'keys[i]'
+ */
+t_hmap * hmap_build_from_arrays(void const ** keys, void const ** datas, unsigned long int n, unsigned int threads,
+                                t_hash_function hashf, t_cmp_function keycmpf, t_function keyfreef, t_function datafreef) {
+    //number of lists, as the map would have grown to hold 'n' values
+    unsigned long int capacity = HMAP_MIN_CAPACITY;
+    while (capacity * HMAP_MAX_LOAD < n) {
+        capacity = capacity << 1;
+    }
+    t_hmap * hmap = hmap_new(capacity, hashf, keycmpf, keyfreef, datafreef);
+    if (hmap == NULL || n == 0) {
+        return (hmap);
+    }
+
+    t_hmap_build build;
+    build.hmap = hmap;
+    build.keys = keys;
+    build.datas = datas;
+    build.n = n;
+    build.threads = threads == 0 ? 1 : threads;
+    if (build.threads > HMAP_BUILD_MAX_THREADS) {
+        build.threads = HMAP_BUILD_MAX_THREADS;
+    }
+    build.partitions = HMAP_BUILD_PARTITIONS;
+    while (build.partitions > hmap->capacity) {
+        build.partitions = build.partitions >> 1;
+    }
+    build.shift = 0;
+    while ((build.partitions << build.shift) < hmap->capacity) {
+        ++build.shift;
+    }
+    build.next_partition = 0;
+
+    hmap->slab_size = sizeof(t_list_node) * hmap->capacity + HMAP_BUILD_NODE_SIZE * n;
+    hmap->slab = malloc(hmap->slab_size);
+    build.hashes = (unsigned long int *)malloc(sizeof(unsigned long int) * n);
+    build.counts = (size_t *)calloc(build.threads * build.partitions, sizeof(size_t));
+    build.firsts = (size_t *)malloc(sizeof(size_t) * (build.partitions + 1));
+    if (hmap->slab == NULL || build.hashes == NULL || build.counts == NULL || build.firsts == NULL) {
+        free(build.hashes);
+        free(build.counts);
+        free(build.firsts);
+        hmap_delete(hmap);
+        return (NULL);
+    }
+    build.heads = (t_list_node *)hmap->slab;
+    build.nodes = (BYTE *)(build.heads + hmap->capacity);
+
+    parallel_run(&build, build.threads, hmap_build_hash);
+
+    //the nodes of a partition follow each other, ordered by thread range
+    parallel_prefix_sums(build.counts, build.firsts, build.threads, build.partitions);
+
+    parallel_run(&build, build.threads, hmap_build_scatter);
+    parallel_run(&build, build.threads, hmap_build_link);
+
+    hmap->size = n;
+    free(build.hashes);
+    free(build.counts);
+    free(build.firsts);
+    return (hmap);
+}
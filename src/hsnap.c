@@ -0,0 +1,205 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "hsnap.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/** internal function : round up to a multiple of 8 bytes, so every part of the file is aligned */
+static uint64_t hsnap_align(uint64_t offset) {
+    return ((offset + 7) & ~(uint64_t)7);
+}
+
+/** internal function : write 'size' bytes, followed by the padding up to the next multiple of 8 */
+static int hsnap_write(FILE * file, void const * bytes, uint64_t size) {
+    static BYTE const zeroes[8] = {0};
+    uint64_t padding = hsnap_align(size) - size;
+    return ((size == 0 || fwrite(bytes, 1, size, file) == size)
+            && (padding == 0 || fwrite(zeroes, 1, padding, file) == padding));
+}
+
+/**
+ *	Save the hash map in a snapshot file
+ *	return 1 if the file was written, 0 elseway
+ */
+int hsnap_save(t_hmap * hmap, char const * path, t_size_function keysizef, t_size_function datasizef) {
+    uint64_t n = hmap->size;
+    uint64_t nbuckets = 1;
+    while (nbuckets < n) {
+        nbuckets = nbuckets << 1;
+    }
+
+    t_hsnap_header header;
+    memset(&header, 0, sizeof(t_hsnap_header));
+    memcpy(header.magic, HSNAP_MAGIC, sizeof(header.magic));
+    header.version = HSNAP_VERSION;
+    header.entry_size = sizeof(t_hsnap_entry);
+    header.nbuckets = nbuckets;
+    header.size = n;
+    header.buckets = hsnap_align(sizeof(t_hsnap_header));
+    header.entries = header.buckets + sizeof(uint64_t) * (nbuckets + 1);
+
+    //the entries, and the key / data pointers of each of them
+    uint64_t * buckets = (uint64_t *)calloc(nbuckets + 1, sizeof(uint64_t));
+    t_hsnap_entry * entries = (t_hsnap_entry *)malloc(sizeof(t_hsnap_entry) * (n + 1));
+    void const ** pointers = (void const **)malloc(sizeof(void const *) * 2 * (n + 1));
+    FILE * file = NULL;
+    int success = 0;
+    if (buckets == NULL || entries == NULL || pointers == NULL) {
+        goto end;
+    }
+
+    //count the entries of each bucket, then make the counts the bucket starts
+    HMAP_ITER_START(hmap, void const *, data) {
+        (void)data;
+        buckets[(node->hash & (nbuckets - 1)) + 1]++;
+    }
+    HMAP_ITER_END(hmap, void const *, data)
+    uint64_t b;
+    for (b = 0 ; b < nbuckets ; b++) {
+        buckets[b + 1] += buckets[b];
+    }
+
+    //place each entry in its bucket ('buckets[b]' is moved to the end of the bucket, and shifted back after)
+    HMAP_ITER_START(hmap, void const *, data) {
+        uint64_t k = buckets[node->hash & (nbuckets - 1)]++;
+        entries[k].hash = node->hash;
+        entries[k].key_size = keysizef(node->key);
+        entries[k].data_size = datasizef(data);
+        pointers[k * 2] = node->key;
+        pointers[k * 2 + 1] = data;
+    }
+    HMAP_ITER_END(hmap, void const *, data)
+    for (b = nbuckets ; b > 0 ; b--) {
+        buckets[b] = buckets[b - 1];
+    }
+    buckets[0] = 0;
+
+    //the keys and data bytes follows the entries
+    uint64_t offset = header.entries + sizeof(t_hsnap_entry) * n;
+    uint64_t k;
+    for (k = 0 ; k < n ; k++) {
+        entries[k].key = offset;
+        offset += hsnap_align(entries[k].key_size);
+        entries[k].data = offset;
+        offset += hsnap_align(entries[k].data_size);
+    }
+    header.file_size = offset;
+
+    file = fopen(path, "wb");
+    if (file == NULL
+            || !hsnap_write(file, &header, sizeof(t_hsnap_header))
+            || !hsnap_write(file, buckets, sizeof(uint64_t) * (nbuckets + 1))
+            || !hsnap_write(file, entries, sizeof(t_hsnap_entry) * n)) {
+        goto end;
+    }
+    for (k = 0 ; k < n ; k++) {
+        if (!hsnap_write(file, pointers[k * 2], entries[k].key_size)
+                || !hsnap_write(file, pointers[k * 2 + 1], entries[k].data_size)) {
+            goto end;
+        }
+    }
+    success = 1;
+
+end:
+    if (file != NULL && fclose(file) != 0) {
+        success = 0;
+    }
+    free(buckets);
+    free(entries);
+    free(pointers);
+    return (success);
+}
+
+/**
+ *	internal function : return 1 if the mapped file is a valid snapshot, 0 elseway.
+ *	Only the header is checked, so opening a snapshot doesnt read the whole file.
+ */
+static int hsnap_check(BYTE const * base, uint64_t file_size) {
+    if (file_size < sizeof(t_hsnap_header)) {
+        return (0);
+    }
+    t_hsnap_header const * header = (t_hsnap_header const *)base;
+    if (memcmp(header->magic, HSNAP_MAGIC, sizeof(header->magic)) != 0
+            || header->version != HSNAP_VERSION
+            || header->entry_size != sizeof(t_hsnap_entry)
+            || header->file_size != file_size
+            || header->nbuckets == 0
+            || (header->nbuckets & (header->nbuckets - 1)) != 0
+            || header->nbuckets > file_size / sizeof(uint64_t)
+            || header->size > file_size / sizeof(t_hsnap_entry)
+            || header->buckets + sizeof(uint64_t) * (header->nbuckets + 1) > file_size
+            || header->entries + sizeof(t_hsnap_entry) * header->size > file_size) {
+        return (0);
+    }
+    uint64_t const * buckets = (uint64_t const *)(base + header->buckets);
+    return (buckets[header->nbuckets] == header->size);
+}
+
+/**
+ *	Map a snapshot file in memory, read only
+ */
+t_hsnap * hsnap_open(char const * path, t_hash_function hashf, t_cmp_function keycmpf) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return (NULL);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return (NULL);
+    }
+    //the mapping stays valid once the file is closed
+    void * base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return (NULL);
+    }
+
+    t_hsnap * hsnap = (t_hsnap *)malloc(sizeof(t_hsnap));
+    if (hsnap == NULL || !hsnap_check((BYTE const *)base, (uint64_t)st.st_size)) {
+        free(hsnap);
+        munmap(base, (size_t)st.st_size);
+        return (NULL);
+    }
+    hsnap->base = (BYTE const *)base;
+    hsnap->header = (t_hsnap_header const *)base;
+    hsnap->buckets = (uint64_t const *)(hsnap->base + hsnap->header->buckets);
+    hsnap->entries = (t_hsnap_entry const *)(hsnap->base + hsnap->header->entries);
+    hsnap->size = hsnap->header->size;
+    hsnap->hashf = hashf;
+    hsnap->keycmpf = keycmpf;
+    return (hsnap);
+}
+
+/**
+ *	Unmap the snapshot
+ */
+void hsnap_close(t_hsnap * hsnap) {
+    munmap((void *)hsnap->base, hsnap->header->file_size);
+    free(hsnap);
+}
+
+/**
+ *	Get data from the snapshot (a pointer in the mapped file), NULL if the key isnt found
+ */
+void const * hsnap_get(t_hsnap * hsnap, void const * key) {
+    unsigned long int hash = hsnap->hashf(key);
+    uint64_t b = hash & (hsnap->header->nbuckets - 1);
+    uint64_t i;
+    for (i = hsnap->buckets[b] ; i < hsnap->buckets[b + 1] ; i++) {
+        t_hsnap_entry const * entry = hsnap->entries + i;
+        if (entry->hash == hash && hsnap->keycmpf(key, hsnap->base + entry->key) == 0) {
+            return (hsnap->base + entry->data);
+        }
+    }
+    return (NULL);
+}
@@ -0,0 +1,149 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "intern.h"
+
+/** the string searched in the pool, sent as key to the map comparison function */
+typedef struct  s_intern_query {
+    char const * str; //the characters
+    unsigned long int length; //number of characters
+}               t_intern_query;
+
+/**
+ *	internal function : the map comparison function, between a query and an interned string
+ */
+static int intern_query_cmp(t_intern_query const * query, char const * str) {
+    if (query->length != intern_length(str)) {
+        return (1);
+    }
+    return (memcmp(query->str, str, query->length));
+}
+
+/**
+ *	Create a new pool
+ */
+t_intern * intern_new(unsigned long int capacity) {
+    t_intern * pool = (t_intern *)malloc(sizeof(t_intern));
+    if (pool == NULL) {
+        return (NULL);
+    }
+    //the strings are freed with the arena: the map doesnt free them.
+    //It is only used with the hashes computed by the pool ('hmap_*_hashed()'), so it has no hash function
+    pool->hmap = hmap_new(capacity, NULL, (t_cmp_function)intern_query_cmp, NULL, NULL);
+    if (pool->hmap == NULL) {
+        free(pool);
+        return (NULL);
+    }
+    pool->chunks = NULL;
+    pool->bytes = 0;
+    return (pool);
+}
+
+/**
+ *	Delete the pool: every interned string is freed
+ */
+void intern_delete(t_intern * pool) {
+    while (pool->chunks) {
+        t_intern_chunk * next = pool->chunks->next;
+        free(pool->chunks);
+        pool->chunks = next;
+    }
+    hmap_delete(pool->hmap);
+    free(pool);
+}
+
+/**
+ *	internal function : allocate 'size' bytes in the arena (8 bytes aligned)
+ */
+static void * intern_alloc(t_intern * pool, unsigned long int size) {
+    size = (size + 7) & ~7UL;
+    t_intern_chunk * chunk = pool->chunks;
+    if (chunk == NULL || chunk->used + size > chunk->size) {
+        //long strings get a chunk of their own, behind the current one, so its free space isnt lost
+        unsigned long int chunksize = size > INTERN_CHUNK_SIZE / 4 ? size : INTERN_CHUNK_SIZE;
+        t_intern_chunk * fresh = (t_intern_chunk *)malloc(sizeof(t_intern_chunk) + chunksize);
+        if (fresh == NULL) {
+            return (NULL);
+        }
+        fresh->size = chunksize;
+        fresh->used = 0;
+        if (chunk != NULL && chunksize != INTERN_CHUNK_SIZE) {
+            fresh->next = chunk->next;
+            chunk->next = fresh;
+        } else {
+            fresh->next = chunk;
+            pool->chunks = fresh;
+        }
+        chunk = fresh;
+    }
+    void * ptr = (BYTE *)(chunk + 1) + chunk->used;
+    chunk->used += size;
+    return (ptr);
+}
+
+/**
+ *	Intern the 'length' first bytes of 'str'
+ */
+char const * intern_bytes(t_intern * pool, char const * str, unsigned long int length) {
+    t_intern_query query = {str, length};
+    unsigned long int hash = hash_bytes(str, length, 0);
+    char const * interned = (char const *)hmap_get_hashed(pool->hmap, &query, hash);
+    if (interned != NULL) {
+        return (interned);
+    }
+
+    unsigned long int size = sizeof(t_intern_string) + length + 1;
+    t_intern_string * header = (t_intern_string *)intern_alloc(pool, size);
+    if (header == NULL) {
+        return (NULL);
+    }
+    header->hash = hash;
+    header->length = length;
+    char * copy = (char *)(header + 1);
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    if (hmap_insert_hashed(pool->hmap, copy, copy, hash) == NULL) {
+        return (NULL); //the arena bytes are lost until the pool is deleted
+    }
+    pool->bytes += size;
+    return (copy);
+}
+
+/**
+ *	Intern the string
+ */
+char const * intern_string(t_intern * pool, char const * str) {
+    return (intern_bytes(pool, str, strlen(str)));
+}
+
+/**
+ *	Return the canonical copy of the string, NULL if it wasnt interned
+ */
+char const * intern_get(t_intern * pool, char const * str) {
+    t_intern_query query = {str, strlen(str)};
+    return ((char const *)hmap_get_hashed(pool->hmap, &query, hash_bytes(str, query.length, 0)));
+}
+
+/**
+ *	Hash and length of an interned string, read from its header
+ */
+unsigned long int intern_hash(char const * str) {
+    return (((t_intern_string const *)str - 1)->hash);
+}
+
+unsigned long int intern_length(char const * str) {
+    return (((t_intern_string const *)str - 1)->length);
+}
+
+/**
+ *	Compare two interned strings: their pointers are compared
+ */
+int intern_cmp(char const * a, char const * b) {
+    return (a != b);
+}
@@ -0,0 +1,476 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "lfmap.h"
+
+/** internal macros : the lowest bit of a 'next' field marks its node as removed */
+#define LFMAP_PTR(N)    ((t_lfmap_node *)((N) & ~(uintptr_t)1))
+#define LFMAP_MARKED(N) ((N) & (uintptr_t)1)
+
+/** internal function : reverse the bits of a word */
+static unsigned long int lfmap_reverse(unsigned long int x) {
+    unsigned long int r = 0;
+    unsigned int i;
+    for (i = 0 ; i < sizeof(unsigned long int) * 8 ; i += 8) {
+        BYTE b = (BYTE)(x >> i);
+        //reverse the bits of the byte
+        b = (BYTE)((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+        b = (BYTE)((b & 0xCC) >> 2 | (b & 0x33) << 2);
+        b = (BYTE)((b & 0xAA) >> 1 | (b & 0x55) << 1);
+        r = (r << 8) | b;
+    }
+    return (r);
+}
+
+/** internal function : the hash without its highest bit, which is lost once reversed in a split order key */
+static unsigned long int lfmap_hash(t_lfmap * lfmap, void const * key) {
+    return (lfmap->hashf(key) & (~0UL >> 1));
+}
+
+/** internal functions : split order keys of a value and of a bucket dummy node */
+static unsigned long int lfmap_so_value(unsigned long int hash) {
+    return (lfmap_reverse(hash) | 1);
+}
+
+static unsigned long int lfmap_so_dummy(unsigned long int bucket) {
+    return (lfmap_reverse(bucket));
+}
+
+/** internal function : the bucket whose dummy node precedes the given bucket one (its highest bit cleared) */
+static unsigned long int lfmap_parent(unsigned long int bucket) {
+    return (bucket & ~(1UL << (sizeof(unsigned long int) * 8 - 1 - __builtin_clzl(bucket))));
+}
+
+/** internal function : segment and index in the segment of a bucket */
+static void lfmap_bucket_index(unsigned long int bucket, unsigned int * segment, unsigned long int * index) {
+    if (bucket == 0) {
+        *segment = 0;
+        *index = 0;
+        return ;
+    }
+    //segment 's' holds the buckets [2^(s-1), 2^s[
+    *segment = (unsigned int)(sizeof(unsigned long int) * 8 - __builtin_clzl(bucket));
+    *index = bucket - (1UL << (*segment - 1));
+}
+
+/** internal function : return the dummy node of the bucket, NULL if it isnt initialized yet */
+static t_lfmap_node * lfmap_get_bucket(t_lfmap * lfmap, unsigned long int bucket) {
+    unsigned int s;
+    unsigned long int i;
+    lfmap_bucket_index(bucket, &s, &i);
+    t_lfmap_bucket * segment = atomic_load_explicit(lfmap->segments + s, memory_order_acquire);
+    if (segment == NULL) {
+        return (NULL);
+    }
+    return (atomic_load_explicit(segment + i, memory_order_acquire));
+}
+
+/** internal function : save the dummy node of the bucket, allocating its segment if needed */
+static int lfmap_set_bucket(t_lfmap * lfmap, unsigned long int bucket, t_lfmap_node * dummy) {
+    unsigned int s;
+    unsigned long int i;
+    lfmap_bucket_index(bucket, &s, &i);
+    t_lfmap_bucket * segment = atomic_load(lfmap->segments + s);
+    if (segment == NULL) {
+        unsigned long int n = s == 0 ? 1 : 1UL << (s - 1);
+        t_lfmap_bucket * expected = NULL;
+        segment = (t_lfmap_bucket *)calloc(n, sizeof(t_lfmap_bucket));
+        if (segment == NULL) {
+            return (0);
+        }
+        //another thread may have allocated it meanwhile
+        if (!atomic_compare_exchange_strong(lfmap->segments + s, &expected, segment)) {
+            free(segment);
+            segment = expected;
+        }
+    }
+    t_lfmap_node * expected = NULL;
+    atomic_compare_exchange_strong(segment + i, &expected, dummy);
+    return (1);
+}
+
+/** internal function : keep an unlinked node until 'lfmap_reclaim()' */
+static void lfmap_retire(t_lfmap * lfmap, t_lfmap_node * node) {
+    t_lfmap_node * head = atomic_load(&(lfmap->retired));
+    do {
+        node->retired = head;
+    } while (!atomic_compare_exchange_weak(&(lfmap->retired), &head, node));
+}
+
+/**
+ *	internal function : search the node of the given split order key (and key, for values),
+ *	starting from the dummy node 'head'. Removed nodes met on the way are unlinked.
+ *
+ *	return 1 if it was found, 0 elseway. In both cases, '*prevp' is set to the 'next' field
+ *	which points to '*curp', the first node not lower than the searched one.
+ */
+static int lfmap_find(t_lfmap * lfmap, t_lfmap_node * head, unsigned long int so_key, void const * key,
+        _Atomic(uintptr_t) ** prevp, t_lfmap_node ** curp) {
+retry:
+    {
+        _Atomic(uintptr_t) * prev = &(head->next);
+        t_lfmap_node * cur = LFMAP_PTR(atomic_load(prev));
+        while (cur != NULL) {
+            uintptr_t next = atomic_load(&(cur->next));
+            if (LFMAP_MARKED(next)) {
+                //'cur' is removed: unlink it
+                uintptr_t expected = (uintptr_t)cur;
+                if (!atomic_compare_exchange_strong(prev, &expected, next & ~(uintptr_t)1)) {
+                    goto retry;
+                }
+                lfmap_retire(lfmap, cur);
+                cur = LFMAP_PTR(next);
+                continue ;
+            }
+            if (atomic_load(prev) != (uintptr_t)cur) {
+                goto retry;
+            }
+            if (cur->so_key > so_key) {
+                break ;
+            }
+            //dummy nodes have unique split order keys, values may share it: compare the keys
+            if (cur->so_key == so_key && (key == NULL || lfmap->keycmpf(key, cur->key) == 0)) {
+                *prevp = prev;
+                *curp = cur;
+                return (1);
+            }
+            prev = &(cur->next);
+            cur = LFMAP_PTR(next);
+        }
+        *prevp = prev;
+        *curp = cur;
+        return (0);
+    }
+}
+
+/**
+ *	internal function : return the dummy node of the bucket, initializing it (and its parents) if needed
+ */
+static t_lfmap_node * lfmap_init_bucket(t_lfmap * lfmap, unsigned long int bucket) {
+    t_lfmap_node * dummy = lfmap_get_bucket(lfmap, bucket);
+    if (dummy != NULL) {
+        return (dummy);
+    }
+
+    unsigned long int parent = lfmap_parent(bucket);
+    t_lfmap_node * head = lfmap_init_bucket(lfmap, parent);
+    if (head == NULL) {
+        return (NULL);
+    }
+
+    dummy = (t_lfmap_node *)malloc(sizeof(t_lfmap_node));
+    if (dummy == NULL) {
+        return (NULL);
+    }
+    dummy->so_key = lfmap_so_dummy(bucket);
+    dummy->key = NULL;
+    dummy->data = NULL;
+
+    while (1) {
+        _Atomic(uintptr_t) * prev;
+        t_lfmap_node * cur;
+        if (lfmap_find(lfmap, head, dummy->so_key, NULL, &prev, &cur)) {
+            //another thread inserted it first
+            free(dummy);
+            dummy = cur;
+            break ;
+        }
+        atomic_store(&(dummy->next), (uintptr_t)cur);
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, (uintptr_t)dummy)) {
+            break ;
+        }
+    }
+    //if this fails, the node stays reachable from its parent: lookups still work
+    lfmap_set_bucket(lfmap, bucket, dummy);
+    return (dummy);
+}
+
+/**
+ *	Create a new lock-free hashmap:
+ *
+ *	capacity : number of values the map should hold before growing
+ *	hashf    : hash function to use on inserted elements
+ *	keycmpf  : comparison function to use when searching a data
+ */
+t_lfmap * lfmap_new(unsigned long int capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+
+    t_lfmap * lfmap = (t_lfmap *)malloc(sizeof(t_lfmap));
+    if (lfmap == NULL) {
+        return (NULL);
+    }
+    t_lfmap_node * dummy = (t_lfmap_node *)malloc(sizeof(t_lfmap_node));
+    if (dummy == NULL) {
+        free(lfmap);
+        return (NULL);
+    }
+    dummy->so_key = lfmap_so_dummy(0);
+    dummy->key = NULL;
+    dummy->data = NULL;
+    atomic_init(&(dummy->next), (uintptr_t)0);
+
+    unsigned int s;
+    for (s = 0 ; s < LFMAP_SEGMENTS ; s++) {
+        atomic_init(lfmap->segments + s, NULL);
+    }
+
+    // set the number of buckets to the closest power of two
+    unsigned long int c = 1;
+    while (c * LFMAP_MAX_LOAD < capacity) {
+        c = c << 1;
+    }
+    atomic_init(&(lfmap->nbuckets), c);
+    atomic_init(&(lfmap->size), 0);
+    atomic_init(&(lfmap->retired), NULL);
+    lfmap->hashf = hashf;
+    lfmap->keycmpf = keycmpf;
+    lfmap->datafreef = datafreef;
+    lfmap->keyfreef = keyfreef;
+
+    if (!lfmap_set_bucket(lfmap, 0, dummy)) {
+        free(dummy);
+        free(lfmap);
+        return (NULL);
+    }
+    return (lfmap);
+}
+
+/** internal function : free a node, its key and its data */
+static void lfmap_free_node(t_lfmap * lfmap, t_lfmap_node * node) {
+    if (node->key != NULL) {
+        if (lfmap->datafreef) {
+            lfmap->datafreef(node->data);
+        }
+        if (lfmap->keyfreef) {
+            lfmap->keyfreef(node->key);
+        }
+    }
+    free(node);
+}
+
+/**
+ *	Free the removed nodes (and call 'keyfreef' / 'datafreef' on them).
+ *	No other thread should use the map during this call.
+ */
+void lfmap_reclaim(t_lfmap * lfmap) {
+    t_lfmap_node * node = atomic_exchange(&(lfmap->retired), NULL);
+    while (node != NULL) {
+        t_lfmap_node * next = node->retired;
+        lfmap_free_node(lfmap, node);
+        node = next;
+    }
+}
+
+/**
+ *	Delete the hashmap from the heap (no other thread should use it anymore)
+ */
+void lfmap_delete(t_lfmap * lfmap) {
+    lfmap_reclaim(lfmap);
+
+    //every node (dummy or not) is in the list starting at bucket 0
+    t_lfmap_node * node = lfmap_get_bucket(lfmap, 0);
+    while (node != NULL) {
+        t_lfmap_node * next = LFMAP_PTR(atomic_load(&(node->next)));
+        lfmap_free_node(lfmap, node);
+        node = next;
+    }
+
+    unsigned int s;
+    for (s = 0 ; s < LFMAP_SEGMENTS ; s++) {
+        free(atomic_load(lfmap->segments + s));
+    }
+    free(lfmap);
+}
+
+/**
+ *	Insert a value into the hashmap
+ *	return the given data if it was inserted, NULL if the key was already set (or not enough memory)
+ */
+void const * lfmap_insert(t_lfmap * lfmap, void const * data, void const * key) {
+    unsigned long int hash = lfmap_hash(lfmap, key);
+    unsigned long int nbuckets = atomic_load(&(lfmap->nbuckets));
+    t_lfmap_node * head = lfmap_init_bucket(lfmap, hash & (nbuckets - 1));
+    if (head == NULL) {
+        return (NULL);
+    }
+
+    t_lfmap_node * node = (t_lfmap_node *)malloc(sizeof(t_lfmap_node));
+    if (node == NULL) {
+        return (NULL);
+    }
+    node->so_key = lfmap_so_value(hash);
+    node->key = key;
+    node->data = data;
+
+    while (1) {
+        _Atomic(uintptr_t) * prev;
+        t_lfmap_node * cur;
+        if (lfmap_find(lfmap, head, node->so_key, key, &prev, &cur)) {
+            free(node);
+            return (NULL);
+        }
+        atomic_store(&(node->next), (uintptr_t)cur);
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, (uintptr_t)node)) {
+            break ;
+        }
+    }
+
+    //double the number of buckets if the map is too loaded: no node moves, new buckets are initialized lazily
+    unsigned long int size = atomic_fetch_add(&(lfmap->size), 1) + 1;
+    if (size > nbuckets * LFMAP_MAX_LOAD && nbuckets < (1UL << (LFMAP_SEGMENTS - 2))) {
+        atomic_compare_exchange_strong(&(lfmap->nbuckets), &nbuckets, nbuckets << 1);
+    }
+    return (data);
+}
+
+/**
+ *	Get data from the hashmap, NULL if the key isnt found
+ */
+void * lfmap_get(t_lfmap * lfmap, void const * key) {
+    unsigned long int hash = lfmap_hash(lfmap, key);
+    unsigned long int so_key = lfmap_so_value(hash);
+    unsigned long int bucket = hash & (atomic_load_explicit(&(lfmap->nbuckets), memory_order_relaxed) - 1);
+
+    //no bucket is initialized here: the search starts from the closest initialized parent
+    t_lfmap_node * head = lfmap_get_bucket(lfmap, bucket);
+    while (head == NULL) {
+        bucket = lfmap_parent(bucket);
+        head = lfmap_get_bucket(lfmap, bucket);
+    }
+
+    t_lfmap_node * cur = LFMAP_PTR(atomic_load_explicit(&(head->next), memory_order_acquire));
+    while (cur != NULL && cur->so_key <= so_key) {
+        uintptr_t next = atomic_load_explicit(&(cur->next), memory_order_acquire);
+        if (cur->so_key == so_key && !LFMAP_MARKED(next) && lfmap->keycmpf(key, cur->key) == 0) {
+            return ((void *)cur->data);
+        }
+        cur = LFMAP_PTR(next);
+    }
+    return (NULL);
+}
+
+/**
+ *	Remove the data which match with the given key from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int lfmap_remove_key(t_lfmap * lfmap, void const * key) {
+    unsigned long int hash = lfmap_hash(lfmap, key);
+    unsigned long int so_key = lfmap_so_value(hash);
+    unsigned long int nbuckets = atomic_load(&(lfmap->nbuckets));
+    t_lfmap_node * head = lfmap_init_bucket(lfmap, hash & (nbuckets - 1));
+    if (head == NULL) {
+        return (0);
+    }
+
+    while (1) {
+        _Atomic(uintptr_t) * prev;
+        t_lfmap_node * cur;
+        if (!lfmap_find(lfmap, head, so_key, key, &prev, &cur)) {
+            return (0);
+        }
+        uintptr_t next = atomic_load(&(cur->next));
+        if (LFMAP_MARKED(next)) {
+            continue ;
+        }
+        //mark the node as removed: from now on, no node can be linked after it
+        if (!atomic_compare_exchange_strong(&(cur->next), &next, next | 1)) {
+            continue ;
+        }
+        //then unlink it (or let the next search do it)
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, next)) {
+            lfmap_retire(lfmap, cur);
+        } else {
+            lfmap_find(lfmap, head, so_key, key, &prev, &cur);
+        }
+        atomic_fetch_sub(&(lfmap->size), 1);
+        return (1);
+    }
+}
+
+/**
+ *	Number of values in the hashmap
+ */
+unsigned long int lfmap_size(t_lfmap * lfmap) {
+    return (atomic_load(&(lfmap->size)));
+}
+
+/*
+#include <pthread.h>
+
+//scalability benchmark: 95% lookups, 5% insertions / removals, from 1 to 64 threads
+//cc -O3 lfmap.c bench.c -I ../includes -lpthread
+
+#define KEYS    (1 << 20)
+#define OPS     (1 << 22)
+
+static unsigned long int longhash(long const * key) {
+    return (*key * 0x9E3779B97F4A7C15UL);
+}
+
+static int longcmp(long const * a, long const * b) {
+    return (*a != *b);
+}
+
+static t_lfmap * map;
+static long keys[KEYS];
+static int nthreads;
+
+static void * worker(void * arg) {
+    unsigned long int seed = (unsigned long int)arg * 0x9E3779B97F4A7C15UL + 1;
+    unsigned long int ops = OPS / nthreads;
+    unsigned long int i;
+    for (i = 0 ; i < ops ; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        long * key = keys + seed % KEYS;
+        if (seed % 100 < 95) {
+            lfmap_get(map, key);
+        } else if (seed & 128) {
+            lfmap_insert(map, key, key);
+        } else {
+            lfmap_remove_key(map, key);
+        }
+    }
+    return (NULL);
+}
+
+int main() {
+    int i;
+    for (i = 0 ; i < KEYS ; i++) {
+        keys[i] = i;
+    }
+    map = lfmap_new(KEYS, (t_hf)longhash, (t_cmpf)longcmp, NULL, NULL);
+    for (i = 0 ; i < KEYS ; i += 2) {
+        lfmap_insert(map, keys + i, keys + i);
+    }
+
+    for (nthreads = 1 ; nthreads <= 64 ; nthreads *= 2) {
+        pthread_t threads[64];
+        unsigned long int t1, t2;
+        MICROSEC(t1);
+        for (i = 0 ; i < nthreads ; i++) {
+            pthread_create(threads + i, NULL, worker, (void *)(long)i);
+        }
+        for (i = 0 ; i < nthreads ; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        MICROSEC(t2);
+        printf("\t%-4d threads : %lf Mops/s\n", nthreads, OPS / (double)(t2 - t1));
+        lfmap_reclaim(map);
+    }
+
+    lfmap_delete(map);
+    return (0);
+}
+*/
@@ -98,6 +98,47 @@ void list_remove_node(t_list * lst, t_list_node *node) {
 	lst->size--;
 }
 
+/**
+ *	unlink the given node from the list, without freeing it
+ */
+void list_unlink_node(t_list * lst, t_list_node * node) {
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->next = NULL;
+	node->prev = NULL;
+	lst->size--;
+}
+
+/**
+ *	link an already allocated node (see 'list_unlink_node()') at the end of the list
+ */
+void list_add_node(t_list * lst, t_list_node * node) {
+	t_list_node *tmp = lst->head->prev;
+
+	lst->head->prev = node;
+	tmp->next = node;
+
+	node->prev = tmp;
+	node->next = lst->head;
+
+	lst->size++;
+}
+
+/**
+ *	link an already allocated node right before the node 'next' of the list
+ */
+void list_add_node_before(t_list * lst, t_list_node * next, t_list_node * node) {
+	t_list_node *tmp = next->prev;
+
+	next->prev = node;
+	tmp->next = node;
+
+	node->prev = tmp;
+	node->next = next;
+
+	lst->size++;
+}
+
 /**
  * Remove first / last element of the list. Return 1 if it was removed, 0 else
  */
@@ -0,0 +1,161 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "multimap.h"
+
+/**
+ *	Create a new multimap
+ */
+t_multimap * multimap_new(unsigned long int const capacity, t_hash_function hashf, t_cmp_function keycmpf,
+                          t_function keyfreef, t_function datafreef) {
+    t_multimap * map = (t_multimap *)malloc(sizeof(t_multimap));
+    if (map == NULL) {
+        return (NULL);
+    }
+    //the map frees the keys, the multimap frees the arrays and the values
+    map->hmap = hmap_new(capacity, hashf, keycmpf, keyfreef, NULL);
+    if (map->hmap == NULL) {
+        free(map);
+        return (NULL);
+    }
+    map->size = 0;
+    map->spare = NULL;
+    map->datafreef = datafreef;
+    map->keyfreef = keyfreef;
+    return (map);
+}
+
+/**
+ *	internal function : free the values of the array, and the array
+ */
+static void multimap_delete_values(t_multimap * map, t_array * values) {
+    if (map->datafreef) {
+        size_t i;
+        for (i = 0 ; i < values->size ; i++) {
+            map->datafreef(((void **)values->values)[i]);
+        }
+    }
+    array_delete(values);
+}
+
+/**
+ *	Delete the multimap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void multimap_delete(t_multimap * map) {
+    HMAP_ITER_START(map->hmap, t_array *, values) {
+        multimap_delete_values(map, values);
+    }
+    HMAP_ITER_END(map->hmap, t_array *, values)
+    hmap_delete(map->hmap);
+    if (map->spare) {
+        array_delete(map->spare);
+    }
+    free(map);
+}
+
+/**
+ *	Add a value to the key values
+ */
+void const * multimap_insert(t_multimap * map, void const * data, void const * key) {
+    //the key list is walked once: the spare array is inserted if the key isnt found
+    if (map->spare == NULL) {
+        map->spare = array_new(MULTIMAP_VALUES_CAPACITY, sizeof(void const *));
+        if (map->spare == NULL) {
+            return (NULL);
+        }
+    }
+    t_hmap_node * node = hmap_get_or_insert_handle(map->hmap, map->spare, key);
+    if (node == NULL) {
+        return (NULL);
+    }
+
+    t_array * values = (t_array *)node->data;
+    if (values == map->spare) {
+        //a new key: the array was allocated with room for a value, so this cant fail
+        map->spare = NULL;
+        array_add(values, &data);
+    } else {
+        if (array_add(values, &data) == -1) {
+            return (NULL);
+        }
+        //the stored key is kept (unless it is the given one)
+        if (map->keyfreef && node->key != key) {
+            map->keyfreef(key);
+        }
+    }
+    map->size++;
+    return (data);
+}
+
+/**
+ *	Get every value of the key (a span of size 0 if the key isnt found)
+ */
+t_multimap_span multimap_get_all(t_multimap * map, void const * key) {
+    t_multimap_span span = {NULL, 0};
+    t_array * values = (t_array *)hmap_get(map->hmap, key);
+    if (values != NULL) {
+        span.values = (void **)values->values;
+        span.size = values->size;
+    }
+    return (span);
+}
+
+/**
+ *	Get the first value of the key, NULL if the key isnt found
+ */
+void * multimap_get(t_multimap * map, void const * key) {
+    t_array * values = (t_array *)hmap_get(map->hmap, key);
+    if (values == NULL) {
+        return (NULL);
+    }
+    return (((void **)values->values)[0]);
+}
+
+/**
+ *	Remove the data pointer from the key values (the key is removed with its last value)
+ *	return 1 if the element was removed, 0 elseway
+ */
+int multimap_remove_data(t_multimap * map, void const * key, void const * data) {
+    t_array * values = (t_array *)hmap_get(map->hmap, key);
+    if (values == NULL) {
+        return (0);
+    }
+    size_t i;
+    for (i = 0 ; i < values->size ; i++) {
+        if (((void **)values->values)[i] == data) {
+            array_remove(values, i);
+            map->size--;
+            if (map->datafreef) {
+                map->datafreef(data);
+            }
+            if (values->size == 0) {
+                hmap_remove_key(map->hmap, key);
+                array_delete(values);
+            }
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	Remove the key and every of its values from the multimap
+ *	return the number of values removed
+ */
+unsigned long int multimap_remove_key(t_multimap * map, void const * key) {
+    t_array * values = (t_array *)hmap_get(map->hmap, key);
+    if (values == NULL) {
+        return (0);
+    }
+    unsigned long int removed = values->size;
+    hmap_remove_key(map->hmap, key);
+    multimap_delete_values(map, values);
+    map->size -= removed;
+    return (removed);
+}
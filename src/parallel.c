@@ -0,0 +1,76 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "parallel.h"
+#include <pthread.h>
+
+typedef struct  s_parallel_task {
+    void * state; //the state of the algorithm
+    unsigned int thread; //index of the thread
+    t_parallel_phase phase; //the phase run by the thread
+}               t_parallel_task;
+
+/**
+ *	First index of the range of the thread (the last thread range ends at 'n')
+ */
+size_t parallel_from(size_t n, unsigned int threads, unsigned int thread) {
+    return (n / threads * thread + (thread == threads ? n % threads : 0));
+}
+
+static void * parallel_thread(void * param) {
+    t_parallel_task * task = (t_parallel_task *)param;
+    task->phase(task->state, task->thread);
+    return (NULL);
+}
+
+/**
+ *	Run the phase on every thread, and wait for them.
+ *	(the ranges of the threads which couldnt be created are run by the calling thread)
+ */
+void parallel_run(void * state, unsigned int threads, t_parallel_phase phase) {
+    t_parallel_task tasks[PARALLEL_MAX_THREADS];
+    pthread_t tids[PARALLEL_MAX_THREADS];
+    int started[PARALLEL_MAX_THREADS];
+    unsigned int t;
+
+    for (t = 0 ; t < threads && t < PARALLEL_MAX_THREADS ; t++) {
+        tasks[t].state = state;
+        tasks[t].thread = t;
+        tasks[t].phase = phase;
+        started[t] = t > 0 && pthread_create(tids + t, NULL, parallel_thread, tasks + t) == 0;
+    }
+    for (t = 0 ; t < threads ; t++) {
+        if (t >= PARALLEL_MAX_THREADS || !started[t]) {
+            phase(state, t);
+        }
+    }
+    for (t = 1 ; t < threads && t < PARALLEL_MAX_THREADS ; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        }
+    }
+}
+
+/**
+ *	Prefix sums of the per thread counts: the values of a bucket follow each other, ordered by thread
+ */
+void parallel_prefix_sums(size_t * counts, size_t * firsts, unsigned int threads, size_t nbuckets) {
+    size_t index = 0;
+    size_t b;
+    for (b = 0 ; b < nbuckets ; b++) {
+        firsts[b] = index;
+        unsigned int t;
+        for (t = 0 ; t < threads ; t++) {
+            size_t count = counts[t * nbuckets + b];
+            counts[t * nbuckets + b] = index;
+            index += count;
+        }
+    }
+    firsts[nbuckets] = index;
+}
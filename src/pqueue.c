@@ -51,7 +51,7 @@ int pqueue_is_empty(t_pqueue * pqueue) {
 }
 
 /** fonction interne pour recuperer une node */
-static t_pqueue_node * pqueue_get_node(t_pqueue * pqueue, unsigned int i) {
+static t_pqueue_node * pqueue_get_node(t_pqueue * pqueue, size_t i) {
 	return (*((t_pqueue_node **)array_get(pqueue->nodes, i)));
 }
 
@@ -71,17 +71,22 @@ t_pqueue_node * pqueue_insert(t_pqueue * pqueue, void const * key, void const *
 	/** initialise le sommet de la file */
 	node->key	= key;
 	node->value	= value;
-	node->index	= array_add(pqueue->nodes, &node);
+	ssize_t index	= array_add(pqueue->nodes, &node);
+	if (index == -1) {
+		free(node);
+		return (NULL);
+	}
+	node->index	= (size_t)index;
 
 	/** on s'assure de l'intégrité du tas binaire */
 
 	/** le nouveau sommet ayant été inseré à la fin du tas
 	    on le remonte à sa position final, afin de
 	    respecter les regles du tas binaire */
-	unsigned int i = pqueue->nodes->size - 1;
+	size_t i = pqueue->nodes->size - 1;
 	while (i != 0) {
 		/** parent de 'i' */
-		unsigned int pi = (i - 1) / 2;
+		size_t pi = (i - 1) / 2;
 		t_pqueue_node * i_node	= pqueue_get_node(pqueue, i);
 		t_pqueue_node * pi_node	= pqueue_get_node(pqueue, pi);
 		/** si 'i' est plus grand que son père, c'est qu'on a
@@ -111,9 +116,9 @@ void pqueue_decrease(t_pqueue * pqueue, t_pqueue_node * node, void const * newke
 
 	/** sur le meme modele que 'pqueue_insert()', on remonte le tas
 	    pour replacer le sommet au bon endroit */
-	unsigned int i = node->index;
+	size_t i = node->index;
 	while (i != 0) {
-		unsigned int pi = (i - 1) / 2;
+		size_t pi = (i - 1) / 2;
 		t_pqueue_node * i_node	= pqueue_get_node(pqueue, i);
 		t_pqueue_node * pi_node	= pqueue_get_node(pqueue, pi);
 		if (pqueue->cmpf(pi_node->key, i_node->key) < 0) {
@@ -141,11 +146,11 @@ t_pqueue_node * pqueue_minimum(t_pqueue * pqueue) {
  *	recursive, en partant de l'index 'i', puis en redescendant dans
  *	le tas
  */
-static void pqueue_heapify(t_pqueue * pqueue, unsigned int i) {
+static void pqueue_heapify(t_pqueue * pqueue, size_t i) {
 	t_array * nodes = pqueue->nodes;
-	unsigned int l = 2 * i + 1;
-	unsigned int r = 2 * i + 2;
-	unsigned int s = i; /** plus petite clef entre 'i', 'l', et 'r' */
+	size_t l = 2 * i + 1;
+	size_t r = 2 * i + 2;
+	size_t s = i; /** plus petite clef entre 'i', 'l', et 'r' */
 	t_pqueue_node * inode = pqueue_get_node(pqueue, i);
 
 	if (l < nodes->size) {
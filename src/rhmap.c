@@ -0,0 +1,237 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "rhmap.h"
+
+/** internal function : number of values a table of 'capacity' slots can hold */
+static unsigned long int rhmap_max_load(unsigned long int capacity) {
+    return (capacity / 100 * RHMAP_MAX_LOAD + capacity % 100 * RHMAP_MAX_LOAD / 100);
+}
+
+/** internal function : allocate 'capacity' empty slots */
+static t_rhmap_slot * rhmap_new_slots(unsigned long int capacity) {
+    unsigned long int size = sizeof(t_rhmap_slot) * capacity;
+    t_rhmap_slot * slots = (t_rhmap_slot *)malloc(size);
+    if (slots == NULL) {
+        return (NULL);
+    }
+    memset(slots, 0, size);
+    return (slots);
+}
+
+/**
+ *	Create a new hashmap:
+ *
+ *	capacity : number of values the map should hold before growing
+ *	hashf    : hash function to use on inserted elements
+ *	keycmpf  : comparison function to use when searching a data
+ */
+t_rhmap * rhmap_new(unsigned long int const capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+
+    // number of slots : the closest power of two which holds 'capacity' values under the max load
+    unsigned long int c = 8;
+    while (rhmap_max_load(c) < capacity) {
+        c = c << 1;
+    }
+
+    t_rhmap_slot * slots = rhmap_new_slots(c);
+    if (slots == NULL) {
+        return (NULL);
+    }
+
+    t_rhmap * rhmap = (t_rhmap *)malloc(sizeof(t_rhmap));
+    if (rhmap == NULL) {
+        free(slots);
+        return (NULL);
+    }
+
+    rhmap->slots = slots;
+    rhmap->capacity = c;
+    rhmap->size = 0;
+    rhmap->hashf = hashf;
+    rhmap->keycmpf = keycmpf;
+    rhmap->datafreef = datafreef;
+    rhmap->keyfreef = keyfreef;
+
+    return (rhmap);
+}
+
+/**
+ *	Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void rhmap_delete(t_rhmap * rhmap) {
+    if (rhmap->datafreef || rhmap->keyfreef) {
+        unsigned long int i;
+        for (i = 0 ; i < rhmap->capacity ; i++) {
+            if (rhmap->slots[i].psl != 0) {
+                if (rhmap->datafreef) {
+                    rhmap->datafreef(rhmap->slots[i].data);
+                }
+                if (rhmap->keyfreef) {
+                    rhmap->keyfreef(rhmap->slots[i].key);
+                }
+            }
+        }
+    }
+    free(rhmap->slots);
+    free(rhmap);
+}
+
+/**
+ *	internal function : place the slot in the table, robin hood style.
+ *	The table must have a free slot.
+ */
+static void rhmap_place(t_rhmap * rhmap, t_rhmap_slot slot) {
+    unsigned long int mask = rhmap->capacity - 1;
+    unsigned long int i = slot.hash & mask;
+    slot.psl = 1;
+    while (rhmap->slots[i].psl != 0) {
+        //the value in place is closer to its home slot: it gives its slot to the new one
+        if (rhmap->slots[i].psl < slot.psl) {
+            t_rhmap_slot tmp = rhmap->slots[i];
+            rhmap->slots[i] = slot;
+            slot = tmp;
+        }
+        i = (i + 1) & mask;
+        slot.psl++;
+    }
+    rhmap->slots[i] = slot;
+}
+
+/**
+ *	internal function : move every value into a new table of 'capacity' slots
+ */
+static int rhmap_rehash(t_rhmap * rhmap, unsigned long int capacity) {
+    t_rhmap_slot * slots = rhmap_new_slots(capacity);
+    if (slots == NULL) {
+        return (0);
+    }
+    t_rhmap_slot * old = rhmap->slots;
+    unsigned long int old_capacity = rhmap->capacity;
+    rhmap->slots = slots;
+    rhmap->capacity = capacity;
+
+    unsigned long int i;
+    for (i = 0 ; i < old_capacity ; i++) {
+        if (old[i].psl != 0) {
+            rhmap_place(rhmap, old[i]);
+        }
+    }
+    free(old);
+    return (1);
+}
+
+/**
+ *	Insert a value into the hashmap:
+ *
+ *	return the given data if it was inserted properly, NULL elseway
+ */
+void const * rhmap_insert(t_rhmap * rhmap, void const * data, void const * key) {
+    if (rhmap->size + 1 > rhmap_max_load(rhmap->capacity)
+            && !rhmap_rehash(rhmap, rhmap->capacity << 1)) {
+        return (NULL);
+    }
+
+    t_rhmap_slot slot;
+    slot.hash = rhmap->hashf(key);
+    slot.key = key;
+    slot.data = data;
+    rhmap_place(rhmap, slot);
+    rhmap->size++;
+    return (data);
+}
+
+/**
+ *	internal function : return the slot index of the key, or -1 if it isnt found
+ */
+static long int rhmap_find(t_rhmap * rhmap, void const * key) {
+    unsigned long int hash = rhmap->hashf(key);
+    unsigned long int mask = rhmap->capacity - 1;
+    unsigned long int i = hash & mask;
+    unsigned int psl = 1;
+    //the key would have taken any slot closer to its home slot than itself:
+    //the search stops on the first of them
+    while (rhmap->slots[i].psl >= psl) {
+        if (rhmap->slots[i].hash == hash && rhmap->keycmpf(key, rhmap->slots[i].key) == 0) {
+            return ((long int)i);
+        }
+        i = (i + 1) & mask;
+        psl++;
+    }
+    return (-1);
+}
+
+/**
+ *	Get data from the hashmap, NULL if the key isnt found
+ */
+void * rhmap_get(t_rhmap * rhmap, void const * key) {
+    long int i = rhmap_find(rhmap, key);
+    if (i < 0) {
+        return (NULL);
+    }
+    return ((void *)rhmap->slots[i].data);
+}
+
+/**
+ *	internal function : remove the value of the given slot (backward shift deletion),
+ *	and free its data and key
+ */
+static void rhmap_remove_slot(t_rhmap * rhmap, unsigned long int i) {
+    void const * data = rhmap->slots[i].data;
+    void const * key = rhmap->slots[i].key;
+    unsigned long int mask = rhmap->capacity - 1;
+
+    //shift back the following values until an empty slot or a value in its home slot
+    unsigned long int next = (i + 1) & mask;
+    while (rhmap->slots[next].psl > 1) {
+        rhmap->slots[i] = rhmap->slots[next];
+        rhmap->slots[i].psl--;
+        i = next;
+        next = (next + 1) & mask;
+    }
+    rhmap->slots[i].psl = 0;
+    rhmap->size--;
+
+    if (rhmap->datafreef) {
+        rhmap->datafreef(data);
+    }
+    if (rhmap->keyfreef) {
+        rhmap->keyfreef(key);
+    }
+}
+
+/**
+ *	Remove the data pointer from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int rhmap_remove_data(t_rhmap * rhmap, void const * data) {
+    unsigned long int i;
+    for (i = 0 ; i < rhmap->capacity ; i++) {
+        if (rhmap->slots[i].psl != 0 && rhmap->slots[i].data == data) {
+            rhmap_remove_slot(rhmap, i);
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	Remove the data which match with the given key from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int rhmap_remove_key(t_rhmap * rhmap, void const * key) {
+    long int i = rhmap_find(rhmap, key);
+    if (i < 0) {
+        return (0);
+    }
+    rhmap_remove_slot(rhmap, (unsigned long int)i);
+    return (1);
+}
@@ -0,0 +1,160 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "shmap.h"
+
+/**
+ *	Create a new thread safe hashmap:
+ *
+ *	nshards  : number of shards, rounded to the next power of two
+ *	capacity : initial capacity of the hashmap (split between the shards)
+ *	hashf    : hash function to use on inserted elements
+ *	keycmpf  : comparison function to use when searching a data
+ */
+t_shmap * shmap_new(unsigned long int nshards, unsigned long int capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+
+    // set the number of shards to the closest power of two
+    unsigned long int n = 1;
+    unsigned int bits = 0;
+    while (n < nshards) {
+        n = n << 1;
+        ++bits;
+    }
+
+    t_shmap * shmap = (t_shmap *)malloc(sizeof(t_shmap));
+    if (shmap == NULL) {
+        return (NULL);
+    }
+    void * shards;
+    if (posix_memalign(&shards, CACHE_LINE, sizeof(t_shmap_shard) * n) != 0) {
+        free(shmap);
+        return (NULL);
+    }
+    shmap->shards = (t_shmap_shard *)shards;
+    shmap->nshards = n;
+    shmap->shift = (unsigned int)(sizeof(unsigned long int) * 8) - bits;
+    shmap->hashf = hashf;
+
+    unsigned long int i;
+    for (i = 0 ; i < n ; i++) {
+        t_shmap_shard * shard = shmap->shards + i;
+        shard->hmap = hmap_new(capacity / n, hashf, keycmpf, keyfreef, datafreef);
+        if (shard->hmap == NULL || pthread_rwlock_init(&(shard->lock), NULL) != 0) {
+            if (shard->hmap != NULL) {
+                hmap_delete(shard->hmap);
+            }
+            shmap->nshards = i;
+            shmap_delete(shmap);
+            return (NULL);
+        }
+    }
+    return (shmap);
+}
+
+/**
+ *	Delete the hashmap from the heap (no other thread should use it anymore)
+ */
+void shmap_delete(t_shmap * shmap) {
+    unsigned long int i;
+    for (i = 0 ; i < shmap->nshards ; i++) {
+        hmap_delete(shmap->shards[i].hmap);
+        pthread_rwlock_destroy(&(shmap->shards[i].lock));
+    }
+    free(shmap->shards);
+    free(shmap);
+}
+
+/**
+ *	internal function : return the shard of the given hash.
+ *	The hash is mixed (fibonacci hashing) and its high bits are used,
+ *	so the shard doesnt depend on the low bits used by the shard lists.
+ */
+static t_shmap_shard * shmap_shard(t_shmap * shmap, unsigned long int hash) {
+    if (shmap->nshards == 1) {
+        return (shmap->shards);
+    }
+    return (shmap->shards + ((hash * 0x9E3779B97F4A7C15UL) >> shmap->shift));
+}
+
+/**
+ *	Insert a value into the hashmap
+ *	return the given data if it was inserted properly, NULL elseway
+ */
+void const * shmap_insert(t_shmap * shmap, void const * data, void const * key) {
+    unsigned long int hash = shmap->hashf(key);
+    t_shmap_shard * shard = shmap_shard(shmap, hash);
+
+    pthread_rwlock_wrlock(&(shard->lock));
+    void const * r = hmap_insert_hashed(shard->hmap, data, key, hash);
+    pthread_rwlock_unlock(&(shard->lock));
+    return (r);
+}
+
+/**
+ *	Get data from the hashmap, NULL if the key isnt found
+ */
+void * shmap_get(t_shmap * shmap, void const * key) {
+    unsigned long int hash = shmap->hashf(key);
+    t_shmap_shard * shard = shmap_shard(shmap, hash);
+
+    //lookups dont migrate the lists of a resizing shard, so they can share the lock
+    pthread_rwlock_rdlock(&(shard->lock));
+    void * data = hmap_lookup_hashed(shard->hmap, key, hash);
+    pthread_rwlock_unlock(&(shard->lock));
+    return (data);
+}
+
+/**
+ *	Remove the data pointer from the hash map (every shard is searched)
+ *	return 1 if the element was removed, 0 elseway
+ */
+int shmap_remove_data(t_shmap * shmap, void const * data) {
+    unsigned long int i;
+    for (i = 0 ; i < shmap->nshards ; i++) {
+        t_shmap_shard * shard = shmap->shards + i;
+        pthread_rwlock_wrlock(&(shard->lock));
+        int r = hmap_remove_data(shard->hmap, data);
+        pthread_rwlock_unlock(&(shard->lock));
+        if (r) {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	Remove the data which match with the given key from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int shmap_remove_key(t_shmap * shmap, void const * key) {
+    unsigned long int hash = shmap->hashf(key);
+    t_shmap_shard * shard = shmap_shard(shmap, hash);
+
+    pthread_rwlock_wrlock(&(shard->lock));
+    int r = hmap_remove_key_hashed(shard->hmap, key, hash);
+    pthread_rwlock_unlock(&(shard->lock));
+    return (r);
+}
+
+/**
+ *	Number of values in the hashmap
+ */
+unsigned long int shmap_size(t_shmap * shmap) {
+    unsigned long int size = 0;
+    unsigned long int i;
+    for (i = 0 ; i < shmap->nshards ; i++) {
+        t_shmap_shard * shard = shmap->shards + i;
+        pthread_rwlock_rdlock(&(shard->lock));
+        size += shard->hmap->size;
+        pthread_rwlock_unlock(&(shard->lock));
+    }
+    return (size);
+}
@@ -0,0 +1,311 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "swmap.h"
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+/**
+ *	internal functions : split the hash in the group index (h1) and the 7 bits stored in the control byte (h2)
+ */
+static unsigned long int swmap_h1(unsigned long int hash) {
+    return (hash >> 7);
+}
+
+static BYTE swmap_h2(unsigned long int hash) {
+    return ((BYTE)(hash & 0x7F));
+}
+
+/**
+ *	internal functions : return a bit mask of the group control bytes which are equal to 'b',
+ *	or which are empty, or which are empty or deleted (bit i set <=> slot i matches)
+ */
+#ifdef __SSE2__
+static unsigned int swmap_match(BYTE const * group, BYTE b) {
+    __m128i ctrl = _mm_load_si128((__m128i const *)group);
+    return ((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)b))));
+}
+
+static unsigned int swmap_match_empty_or_deleted(BYTE const * group) {
+    //empty and deleted are the only control bytes with the high bit set
+    return ((unsigned int)_mm_movemask_epi8(_mm_load_si128((__m128i const *)group)));
+}
+#else
+static unsigned int swmap_match(BYTE const * group, BYTE b) {
+    unsigned int mask = 0;
+    int i;
+    for (i = 0 ; i < SWMAP_GROUP ; i++) {
+        mask |= (unsigned int)(group[i] == b) << i;
+    }
+    return (mask);
+}
+
+static unsigned int swmap_match_empty_or_deleted(BYTE const * group) {
+    unsigned int mask = 0;
+    int i;
+    for (i = 0 ; i < SWMAP_GROUP ; i++) {
+        mask |= (unsigned int)(group[i] >> 7) << i;
+    }
+    return (mask);
+}
+#endif
+
+static unsigned int swmap_match_empty(BYTE const * group) {
+    return (swmap_match(group, SWMAP_EMPTY));
+}
+
+/** internal function : index of the lowest bit set */
+static unsigned int swmap_first_bit(unsigned int mask) {
+    return ((unsigned int)__builtin_ctz(mask));
+}
+
+/** internal function : number of slots which can be filled before growing */
+static unsigned long int swmap_max_load(unsigned long int capacity) {
+    return (capacity - capacity / 8);
+}
+
+/**
+ *	internal function : allocate the control bytes and the slots of a table of 'capacity' slots
+ *	(both in a single 64 bytes aligned block, so groups are aligned for SSE2 loads)
+ */
+static int swmap_alloc(t_swmap * swmap, unsigned long int capacity) {
+    void * mem;
+    if (posix_memalign(&mem, 64, capacity + capacity * sizeof(t_swmap_slot)) != 0) {
+        return (0);
+    }
+    swmap->ctrl = (BYTE *)mem;
+    swmap->slots = (t_swmap_slot *)((BYTE *)mem + capacity);
+    swmap->capacity = capacity;
+    swmap->growth_left = swmap_max_load(capacity);
+    memset(swmap->ctrl, SWMAP_EMPTY, capacity);
+    return (1);
+}
+
+/**
+ *	Create a new hashmap:
+ *
+ *	capacity : number of values the map should hold before growing
+ *	hashf    : hash function to use on inserted elements
+ *	keycmpf  : comparison function to use when searching a data
+ */
+t_swmap * swmap_new(unsigned long int const capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+
+    // number of slots : the closest power of two which holds 'capacity' values under the max load
+    unsigned long int c = SWMAP_GROUP;
+    while (swmap_max_load(c) < capacity) {
+        c = c << 1;
+    }
+
+    t_swmap * swmap = (t_swmap *)malloc(sizeof(t_swmap));
+    if (swmap == NULL) {
+        return (NULL);
+    }
+    if (!swmap_alloc(swmap, c)) {
+        free(swmap);
+        return (NULL);
+    }
+
+    swmap->size = 0;
+    swmap->hashf = hashf;
+    swmap->keycmpf = keycmpf;
+    swmap->datafreef = datafreef;
+    swmap->keyfreef = keyfreef;
+
+    return (swmap);
+}
+
+/**
+ *	Delete the hashmap from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void swmap_delete(t_swmap * swmap) {
+    if (swmap->datafreef || swmap->keyfreef) {
+        unsigned long int i;
+        for (i = 0 ; i < swmap->capacity ; i++) {
+            if (swmap->ctrl[i] < SWMAP_EMPTY) {
+                if (swmap->datafreef) {
+                    swmap->datafreef(swmap->slots[i].data);
+                }
+                if (swmap->keyfreef) {
+                    swmap->keyfreef(swmap->slots[i].key);
+                }
+            }
+        }
+    }
+    free(swmap->ctrl);
+    free(swmap);
+}
+
+/**
+ *	internal function : return the index of the first empty or deleted slot of the probe sequence of 'hash'
+ *	(the table always has empty slots, so this terminates)
+ */
+static unsigned long int swmap_find_free(t_swmap * swmap, unsigned long int hash) {
+    unsigned long int mask = swmap->capacity / SWMAP_GROUP - 1;
+    unsigned long int g = swmap_h1(hash) & mask;
+    unsigned long int probe = 0;
+    while (1) {
+        BYTE const * group = swmap->ctrl + g * SWMAP_GROUP;
+        unsigned int avail = swmap_match_empty_or_deleted(group);
+        if (avail) {
+            return (g * SWMAP_GROUP + swmap_first_bit(avail));
+        }
+        //triangular probing visits every group once, as the number of groups is a power of two
+        g = (g + ++probe) & mask;
+    }
+}
+
+/**
+ *	internal function : move every value into a new table of 'capacity' slots
+ */
+static int swmap_rehash(t_swmap * swmap, unsigned long int capacity) {
+    t_swmap old = *swmap;
+    if (!swmap_alloc(swmap, capacity)) {
+        return (0);
+    }
+    unsigned long int i;
+    for (i = 0 ; i < old.capacity ; i++) {
+        if (old.ctrl[i] < SWMAP_EMPTY) {
+            unsigned long int hash = swmap->hashf(old.slots[i].key);
+            unsigned long int j = swmap_find_free(swmap, hash);
+            swmap->ctrl[j] = swmap_h2(hash);
+            swmap->slots[j] = old.slots[i];
+        }
+    }
+    swmap->growth_left -= swmap->size;
+    free(old.ctrl);
+    return (1);
+}
+
+/**
+ *	Insert a value into the hashmap:
+ *
+ *	return the given data if it was inserted properly, NULL elseway
+ */
+void const * swmap_insert(t_swmap * swmap, void const * data, void const * key) {
+    unsigned long int hash = swmap->hashf(key);
+    unsigned long int i = swmap_find_free(swmap, hash);
+
+    //an empty slot is about to be used: make room first if there is none left
+    if (swmap->growth_left == 0 && swmap->ctrl[i] == SWMAP_EMPTY) {
+        //if most of the used slots are deleted ones, rehashing at the same capacity is enough
+        unsigned long int capacity = swmap->capacity;
+        if (swmap->size >= swmap_max_load(capacity) / 2) {
+            capacity = capacity << 1;
+        }
+        if (!swmap_rehash(swmap, capacity)) {
+            return (NULL);
+        }
+        i = swmap_find_free(swmap, hash);
+    }
+
+    if (swmap->ctrl[i] == SWMAP_EMPTY) {
+        swmap->growth_left--;
+    }
+    swmap->ctrl[i] = swmap_h2(hash);
+    swmap->slots[i].key = key;
+    swmap->slots[i].data = data;
+    swmap->size++;
+    return (data);
+}
+
+/**
+ *	internal function : return the slot index of the key, or -1 if it isnt found
+ */
+static long int swmap_find(t_swmap * swmap, void const * key) {
+    unsigned long int hash = swmap->hashf(key);
+    BYTE h2 = swmap_h2(hash);
+    unsigned long int mask = swmap->capacity / SWMAP_GROUP - 1;
+    unsigned long int g = swmap_h1(hash) & mask;
+    unsigned long int probe = 0;
+    while (1) {
+        BYTE const * group = swmap->ctrl + g * SWMAP_GROUP;
+        unsigned int match = swmap_match(group, h2);
+        while (match) {
+            unsigned long int i = g * SWMAP_GROUP + swmap_first_bit(match);
+            if (swmap->keycmpf(key, swmap->slots[i].key) == 0) {
+                return ((long int)i);
+            }
+            match &= match - 1;
+        }
+        //an empty slot ends the probe sequence
+        if (swmap_match_empty(group) || probe == mask) {
+            return (-1);
+        }
+        g = (g + ++probe) & mask;
+    }
+}
+
+/**
+ *	Get data from the hashmap, NULL if the key isnt found
+ */
+void * swmap_get(t_swmap * swmap, void const * key) {
+    long int i = swmap_find(swmap, key);
+    if (i < 0) {
+        return (NULL);
+    }
+    return ((void *)swmap->slots[i].data);
+}
+
+/**
+ *	internal function : remove the value of the given slot, and free it data and key
+ */
+static void swmap_remove_slot(t_swmap * swmap, unsigned long int i) {
+    void const * data = swmap->slots[i].data;
+    void const * key = swmap->slots[i].key;
+
+    //if the group still has an empty slot, no probe sequence went through it:
+    //the slot can be marked as empty instead of deleted
+    BYTE const * group = swmap->ctrl + (i & ~(unsigned long int)(SWMAP_GROUP - 1));
+    if (swmap_match_empty(group)) {
+        swmap->ctrl[i] = SWMAP_EMPTY;
+        swmap->growth_left++;
+    } else {
+        swmap->ctrl[i] = SWMAP_DELETED;
+    }
+    swmap->size--;
+
+    if (swmap->datafreef) {
+        swmap->datafreef(data);
+    }
+    if (swmap->keyfreef) {
+        swmap->keyfreef(key);
+    }
+}
+
+/**
+ *	Remove the data pointer from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int swmap_remove_data(t_swmap * swmap, void const * data) {
+    unsigned long int i;
+    for (i = 0 ; i < swmap->capacity ; i++) {
+        if (swmap->ctrl[i] < SWMAP_EMPTY && swmap->slots[i].data == data) {
+            swmap_remove_slot(swmap, i);
+            return (1);
+        }
+    }
+    return (0);
+}
+
+/**
+ *	Remove the data which match with the given key from the hash map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int swmap_remove_key(t_swmap * swmap, void const * key) {
+    long int i = swmap_find(swmap, key);
+    if (i < 0) {
+        return (0);
+    }
+    swmap_remove_slot(swmap, (unsigned long int)i);
+    return (1);
+}
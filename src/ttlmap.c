@@ -0,0 +1,333 @@
+/**
+ *	This file is part of https://github.com/toss-dev/C_data_structures
+ *
+ *	It is under a GNU GENERAL PUBLIC LICENSE
+ *
+ *	This library is still in development, so please, if you find any issue, let me know about it on github.com
+ *	PEREIRA Romain
+ */
+
+#include "ttlmap.h"
+
+/** internal function : milliseconds since the map was created */
+static unsigned long int ttlmap_now(t_ttlmap * ttlmap) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long int)(ts.tv_sec - ttlmap->start.tv_sec) * 1000
+            + (unsigned long int)((ts.tv_nsec - ttlmap->start.tv_nsec) / 1000000L));
+}
+
+/** internal function : level of the wheel which holds the list */
+static unsigned long int ttlmap_level(t_ttlmap * ttlmap, t_list * slot) {
+    return ((unsigned long int)(slot - ttlmap->wheels[0]) / TTLMAP_SLOTS);
+}
+
+/**
+ *	internal function : the deadline of a value which expires in 'ttl' milliseconds.
+ *	It saturates at ULONG_MAX (never expires) instead of wrapping to the past
+ */
+static unsigned long int ttlmap_deadline(unsigned long int now, unsigned long int ttl) {
+    return (ttl > ULONG_MAX - now ? ULONG_MAX : now + ttl);
+}
+
+/**
+ *	internal function : return the wheel list for the given deadline.
+ *	The wheel is chosen by how far the deadline is, and the list by the deadline bits of this wheel.
+ */
+static t_list * ttlmap_slot(t_ttlmap * ttlmap, unsigned long int deadline) {
+    if (deadline < ttlmap->time) {
+        deadline = ttlmap->time;
+    }
+    unsigned long int delta = deadline - ttlmap->time;
+    unsigned long int max = 1UL << (TTLMAP_SLOTS_BITS * TTLMAP_LEVELS);
+    //further than the last wheel: placed as far as possible, and placed again when its list is spread
+    if (delta >= max) {
+        deadline = ttlmap->time + max - 1;
+        delta = max - 1;
+    }
+    unsigned long int level = 0;
+    while (delta >= (1UL << (TTLMAP_SLOTS_BITS * (level + 1)))) {
+        ++level;
+    }
+    unsigned long int i = (deadline >> (TTLMAP_SLOTS_BITS * level)) & (TTLMAP_SLOTS - 1);
+    return (ttlmap->wheels[level] + i);
+}
+
+/** internal function : link the (unlinked) node of the entry in the list of its deadline */
+static void ttlmap_place(t_ttlmap * ttlmap, t_list_node * node) {
+    t_ttlmap_entry * entry = (t_ttlmap_entry *)(node + 1);
+    entry->slot = ttlmap_slot(ttlmap, entry->deadline);
+    list_add_node(entry->slot, node);
+    ttlmap->counts[ttlmap_level(ttlmap, entry->slot)]++;
+}
+
+/** internal function : unlink the node of the entry from its list */
+static void ttlmap_unplace(t_ttlmap * ttlmap, t_list_node * node) {
+    t_ttlmap_entry * entry = (t_ttlmap_entry *)(node + 1);
+    list_unlink_node(entry->slot, node);
+    ttlmap->counts[ttlmap_level(ttlmap, entry->slot)]--;
+}
+
+/**
+ *	Create a new TTL map
+ */
+t_ttlmap * ttlmap_new(unsigned long int const capacity,
+        t_hash_function hashf, t_cmp_function keycmpf,
+        t_function keyfreef, t_function datafreef) {
+    t_ttlmap * ttlmap = (t_ttlmap *)malloc(sizeof(t_ttlmap));
+    if (ttlmap == NULL) {
+        return (NULL);
+    }
+    //the map doesnt own the keys or the entries: the TTL map frees them
+    ttlmap->hmap = hmap_new(capacity, hashf, keycmpf, NULL, NULL);
+    if (ttlmap->hmap == NULL) {
+        free(ttlmap);
+        return (NULL);
+    }
+    memset(ttlmap->wheels, 0, sizeof(ttlmap->wheels));
+    memset(ttlmap->counts, 0, sizeof(ttlmap->counts));
+    t_list * slot;
+    for (slot = ttlmap->wheels[0] ; slot < ttlmap->wheels[0] + TTLMAP_LEVELS * TTLMAP_SLOTS ; slot++) {
+        if (!list_init(slot)) {
+            for (slot = ttlmap->wheels[0] ; slot < ttlmap->wheels[0] + TTLMAP_LEVELS * TTLMAP_SLOTS ; slot++) {
+                free(slot->head);
+            }
+            hmap_delete(ttlmap->hmap);
+            free(ttlmap);
+            return (NULL);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &(ttlmap->start));
+    ttlmap->time = 0;
+    ttlmap->pending = 0;
+    ttlmap->size = 0;
+    ttlmap->datafreef = datafreef;
+    ttlmap->keyfreef = keyfreef;
+    return (ttlmap);
+}
+
+/**
+ *	Delete the map from the heap, calling 'keyfreef' and 'datafreef' on every key and data
+ */
+void ttlmap_delete(t_ttlmap * ttlmap) {
+    t_list * slot;
+    for (slot = ttlmap->wheels[0] ; slot < ttlmap->wheels[0] + TTLMAP_LEVELS * TTLMAP_SLOTS ; slot++) {
+        LIST_ITER_START(slot, t_ttlmap_entry *, entry) {
+            if (ttlmap->datafreef) {
+                ttlmap->datafreef(entry->data);
+            }
+            if (ttlmap->keyfreef) {
+                ttlmap->keyfreef(entry->key);
+            }
+        }
+        LIST_ITER_END(slot, t_ttlmap_entry *, entry)
+        list_clear(slot);
+        free(slot->head);
+    }
+    hmap_delete(ttlmap->hmap);
+    free(ttlmap);
+}
+
+/**
+ *	internal function : remove the entry from the map and its list, and free it
+ */
+static void ttlmap_remove_entry(t_ttlmap * ttlmap, t_ttlmap_entry * entry) {
+    t_list_node * node = (t_list_node *)entry - 1;
+    void const * data = entry->data;
+    void const * key = entry->key;
+
+    hmap_remove_node(ttlmap->hmap, entry->handle);
+    ttlmap->counts[ttlmap_level(ttlmap, entry->slot)]--;
+    list_remove_node(entry->slot, node);
+    ttlmap->size--;
+
+    if (ttlmap->datafreef) {
+        ttlmap->datafreef(data);
+    }
+    if (ttlmap->keyfreef) {
+        ttlmap->keyfreef(key);
+    }
+}
+
+/**
+ *	internal function : advance the wheels by a tick (or more, over the wheels which are empty),
+ *	moving or expiring at most 'budget' entries. If the lists of the tick hold more entries,
+ *	the tick stays pending, and the next call goes on with them.
+ *	return the number of entries moved or expired
+ */
+static unsigned long int ttlmap_tick(t_ttlmap * ttlmap, unsigned long int now, unsigned long int budget) {
+    if (!ttlmap->pending) {
+        //if the first wheels are empty, jump to the next time a list of a further wheel is spread
+        int empty = 0;
+        while (empty < TTLMAP_LEVELS - 1 && ttlmap->counts[empty] == 0) {
+            ++empty;
+        }
+        unsigned long int shift = (unsigned long int)(TTLMAP_SLOTS_BITS * empty);
+        unsigned long int next = ((ttlmap->time >> shift) + 1) << shift;
+        if (next > now) {
+            //nothing happens until 'now'
+            ttlmap->time = now;
+            return (0);
+        }
+        ttlmap->time = next;
+        ttlmap->pending = 1;
+    }
+
+    //spread the lists of the further wheels which went around, from the furthest one
+    //(the lists already spread by a previous call are empty)
+    unsigned long int work = 0;
+    int level;
+    for (level = TTLMAP_LEVELS - 1 ; level > 0 ; level--) {
+        unsigned long int bits = (unsigned long int)(TTLMAP_SLOTS_BITS * level);
+        if ((ttlmap->time & ((1UL << bits) - 1)) == 0) {
+            t_list * slot = ttlmap->wheels[level] + ((ttlmap->time >> bits) & (TTLMAP_SLOTS - 1));
+            while (slot->size > 0) {
+                if (work >= budget) {
+                    return (work);
+                }
+                t_list_node * node = slot->head->next;
+                ttlmap_unplace(ttlmap, node);
+                ttlmap_place(ttlmap, node);
+                ++work;
+            }
+        }
+    }
+
+    //expire the entries of this millisecond
+    t_list * slot = ttlmap->wheels[0] + (ttlmap->time & (TTLMAP_SLOTS - 1));
+    while (slot->size > 0) {
+        if (work >= budget) {
+            return (work);
+        }
+        t_ttlmap_entry * entry = (t_ttlmap_entry *)(slot->head->next + 1);
+        if (entry->deadline <= ttlmap->time) {
+            ttlmap_remove_entry(ttlmap, entry);
+        } else {
+            ttlmap_unplace(ttlmap, slot->head->next);
+            ttlmap_place(ttlmap, (t_list_node *)entry - 1);
+        }
+        ++work;
+    }
+    ttlmap->pending = 0;
+    return (work);
+}
+
+/**
+ *	internal function : advance the wheels to the current time, or until 'budget' entries
+ *	were moved or expired. return the current time
+ */
+static unsigned long int ttlmap_advance(t_ttlmap * ttlmap, unsigned long int budget) {
+    unsigned long int now = ttlmap_now(ttlmap);
+    unsigned long int work = 0;
+    while ((ttlmap->pending || ttlmap->time < now) && work < budget) {
+        if (ttlmap->size == 0) {
+            if (ttlmap->time < now) {
+                ttlmap->time = now;
+            }
+            ttlmap->pending = 0;
+            break ;
+        }
+        work += ttlmap_tick(ttlmap, now, budget - work);
+    }
+    return (now);
+}
+
+/**
+ *	Insert a value which expires in 'ttl' milliseconds
+ */
+void const * ttlmap_insert(t_ttlmap * ttlmap, void const * data, void const * key, unsigned long int ttl) {
+    unsigned long int now = ttlmap_advance(ttlmap, TTLMAP_EXPIRE_STEP);
+    t_ttlmap_entry * entry = (t_ttlmap_entry *)hmap_get(ttlmap->hmap, key);
+    if (entry != NULL) {
+        //replace the value of the key
+        void const * olddata = entry->data;
+        void const * oldkey = entry->key;
+        //the keys are equal: the map node can hold the new key
+        entry->handle->key = key;
+        entry->data = data;
+        entry->key = key;
+        entry->deadline = ttlmap_deadline(now, ttl);
+        ttlmap_unplace(ttlmap, (t_list_node *)entry - 1);
+        ttlmap_place(ttlmap, (t_list_node *)entry - 1);
+        if (ttlmap->datafreef && olddata != data) {
+            ttlmap->datafreef(olddata);
+        }
+        if (ttlmap->keyfreef && oldkey != key) {
+            ttlmap->keyfreef(oldkey);
+        }
+        return (data);
+    }
+
+    t_ttlmap_entry buffer = {key, data, ttlmap_deadline(now, ttl), NULL, NULL};
+    buffer.slot = ttlmap_slot(ttlmap, buffer.deadline);
+    entry = (t_ttlmap_entry *)list_add(buffer.slot, &buffer, sizeof(t_ttlmap_entry));
+    if (entry == NULL) {
+        return (NULL);
+    }
+    entry->handle = hmap_insert_handle(ttlmap->hmap, entry, key);
+    if (entry->handle == NULL) {
+        list_remove_node(entry->slot, (t_list_node *)entry - 1);
+        return (NULL);
+    }
+    ttlmap->counts[ttlmap_level(ttlmap, entry->slot)]++;
+    ttlmap->size++;
+    return (data);
+}
+
+/**
+ *	internal function : return the entry of the key, or NULL if it isnt found, or if it expired
+ *	(it is then removed)
+ */
+static t_ttlmap_entry * ttlmap_find(t_ttlmap * ttlmap, void const * key) {
+    unsigned long int now = ttlmap_advance(ttlmap, TTLMAP_EXPIRE_STEP);
+    t_ttlmap_entry * entry = (t_ttlmap_entry *)hmap_get(ttlmap->hmap, key);
+    if (entry != NULL && entry->deadline <= now) {
+        ttlmap_remove_entry(ttlmap, entry);
+        return (NULL);
+    }
+    return (entry);
+}
+
+/**
+ *	Get data from the map, NULL if the key isnt found or if its value expired
+ */
+void * ttlmap_get(t_ttlmap * ttlmap, void const * key) {
+    t_ttlmap_entry * entry = ttlmap_find(ttlmap, key);
+    return (entry == NULL ? NULL : (void *)entry->data);
+}
+
+/**
+ *	Reset the TTL of the value of the key
+ *	return 1 if the value was found, 0 elseway
+ */
+int ttlmap_touch(t_ttlmap * ttlmap, void const * key, unsigned long int ttl) {
+    t_ttlmap_entry * entry = ttlmap_find(ttlmap, key);
+    if (entry == NULL) {
+        return (0);
+    }
+    entry->deadline = ttlmap_deadline(ttlmap_now(ttlmap), ttl);
+    ttlmap_unplace(ttlmap, (t_list_node *)entry - 1);
+    ttlmap_place(ttlmap, (t_list_node *)entry - 1);
+    return (1);
+}
+
+/**
+ *	Remove the value of the key from the map
+ *	return 1 if the element was removed, 0 elseway
+ */
+int ttlmap_remove_key(t_ttlmap * ttlmap, void const * key) {
+    ttlmap_advance(ttlmap, TTLMAP_EXPIRE_STEP);
+    t_ttlmap_entry * entry = (t_ttlmap_entry *)hmap_get(ttlmap->hmap, key);
+    if (entry == NULL) {
+        return (0);
+    }
+    ttlmap_remove_entry(ttlmap, entry);
+    return (1);
+}
+
+/**
+ *	Remove every expired value now
+ */
+void ttlmap_expire(t_ttlmap * ttlmap) {
+    ttlmap_advance(ttlmap, ~0UL);
+}